@@ -1,23 +1,209 @@
 #pragma once
 
+#include <istream>
 #include <string_view>
+#include "json/parser/document_stream.h"
+#include "json/parser/json_lines.h"
+#include "json/parser/json_reader.h"
+#include "json/parser/parallel.h"
+#include "json/parser/parse_error.h"
 #include "json/parser/parser.h"
+#include "json/parser/sax.h"
+#include "json/token/transcoded_token.h"
+#include "json/utils/mapped_file.h"
+#include "json/utils/result.h"
+#include "json/value/basic_lazy_document.h"
 #include "json/value/basic_value.h"
 
 namespace json {
 /**
- * @brief Parse json value
+ * @brief Parse json value, strings must be shorter than 4GiB letters
  * @param istream, the input stream to parse the json from
+ * @param options, opt-in behaviours of the tokenizer
  */
 template <typename CharT = char>
-BasicValue<CharT> parse(std::basic_istream<CharT> &istream);
+BasicValue<CharT> parse(std::basic_istream<CharT> &istream,
+                        const token::Options &options = {});
 
 /**
- * @brief Parse json value
- * @param istream, the string view to parse the json from
+ * @brief Parse json value, strings must be shorter than 4GiB letters
+ * @param begin, pointer to the first letter of the json
+ * @param end, pointer past the last letter of the json
+ * @param options, opt-in behaviours of the tokenizer; with lazy numbers, the
+ * value references the input, which must outlive it
  */
 template <typename CharT = char>
-BasicValue<CharT> parse(std::basic_string_view<CharT> &str_view);
+BasicValue<CharT> parse(const CharT *begin, const CharT *end,
+                        const token::Options &options = {});
+
+/**
+ * @brief Parse json value, strings must be shorter than 4GiB letters
+ * @param str_view, the string view to parse the json from
+ * @param options, opt-in behaviours of the tokenizer
+ */
+template <typename CharT = char>
+BasicValue<CharT> parse(std::basic_string_view<CharT> str_view,
+                        const token::Options &options = {});
+
+/**
+ * @brief Build a json value out of a tape
+ * @param tape, a tape built successfully; with lazy numbers or strings
+ * referencing the text, the value references the text, which must outlive it
+ * @returns the value, null if the tape is empty because its build failed
+ */
+template <typename CharT = char>
+BasicValue<CharT> parse(const parser::Tape<CharT> &tape);
+
+/**
+ * @brief Parse json value, stopping at the first error
+ * @param begin, pointer to the first letter of the json
+ * @param end, pointer past the last letter of the json
+ * @param options, opt-in behaviours of the tokenizer
+ * @returns the value, or the error with the offset at which it was found
+ */
+template <typename CharT = char>
+utils::Result<BasicValue<CharT>, parser::ParseError> try_parse(
+    const CharT *begin, const CharT *end, const token::Options &options = {});
+
+/**
+ * @brief Parse json value, stopping at the first error
+ * @param str_view, the string view to parse the json from
+ * @param options, opt-in behaviours of the tokenizer
+ * @returns the value, or the error with the offset at which it was found
+ */
+template <typename CharT = char>
+utils::Result<BasicValue<CharT>, parser::ParseError> try_parse(
+    std::basic_string_view<CharT> str_view,
+    const token::Options &options = {});
+
+/**
+ * @brief Parse json value, stopping at the first error
+ * @param istream, the input stream to parse the json from
+ * @param options, opt-in behaviours of the tokenizer
+ * @returns the value, or the error with the offset at which it was found,
+ * the offset is only known for streams that can tell their position
+ */
+template <typename CharT = char>
+utils::Result<BasicValue<CharT>, parser::ParseError> try_parse(
+    std::basic_istream<CharT> &istream, const token::Options &options = {});
+
+/**
+ * @brief Call the methods of a handler for every part of a json value,
+ * without building the value, see `parser::Grammar` for the methods
+ * @param str_view, the string view to parse the json from
+ * @param handler, the handler to call
+ * @param options, opt-in behaviours of the tokenizer
+ * @returns the error with the offset at which it was found, its code is
+ * `kNone` if the json is valid
+ */
+template <typename CharT = char, typename HandlerT>
+parser::ParseError parse_sax(std::basic_string_view<CharT> str_view,
+                             HandlerT &handler,
+                             const token::Options &options = {});
+
+/**
+ * @brief Call the methods of a handler for every part of a json value read
+ * from a stream
+ * @param istream, the input stream to parse the json from
+ * @param handler, the handler to call
+ * @param options, opt-in behaviours of the tokenizer
+ * @returns the error with the offset at which it was found, its code is
+ * `kNone` if the json is valid
+ */
+template <typename CharT = char, typename HandlerT>
+parser::ParseError parse_sax(std::basic_istream<CharT> &istream,
+                             HandlerT &handler,
+                             const token::Options &options = {});
+
+/**
+ * @brief Parse json value out of utf8 bytes into a value of utf16 or utf32
+ * letters, such as `char16_t`, `char32_t` or `wchar_t`
+ *
+ * The text is tokenized as bytes, only the letters of strings are
+ * transcoded. Lazy numbers are not supported and are ignored.
+ *
+ * @param begin, pointer to the first byte of the json
+ * @param end, pointer past the last byte of the json
+ * @param options, opt-in behaviours of the tokenizer
+ */
+template <typename CharT>
+BasicValue<CharT> parse_utf8(const char *begin, const char *end,
+                             const token::Options &options = {});
+
+/**
+ * @brief Parse json value out of utf8 bytes into a value of utf16 or utf32
+ * letters, see `parse_utf8(begin, end, options)`
+ * @param str_view, the utf8 bytes of the json
+ * @param options, opt-in behaviours of the tokenizer
+ */
+template <typename CharT>
+BasicValue<CharT> parse_utf8(std::string_view str_view,
+                             const token::Options &options = {});
+
+/**
+ * @brief Parse json value whose text is an array or an object using the
+ * threads of a pool, see `parser::ParseParallel`
+ * @param str_view, the string view to parse the json from
+ * @param pool, the threads to parse with
+ * @param options, opt-in behaviours of the tokenizer
+ */
+template <typename CharT = char>
+BasicValue<CharT> parse_parallel(std::basic_string_view<CharT> str_view,
+                                 utils::ThreadPool &pool,
+                                 const token::Options &options = {});
+
+/**
+ * @brief Read the values of a text made of json values one after another,
+ * see `parser::DocumentStream`
+ * @param str_view, the string view to read the values from, must outlive the
+ * stream
+ * @param options, opt-in behaviours of the tokenizer
+ * @returns the stream of values
+ */
+template <typename CharT = char>
+parser::DocumentStream<CharT> parse_documents(
+    std::basic_string_view<CharT> str_view,
+    const token::Options &options = {});
+
+/**
+ * @brief Read the values of a stream made of json values one after another
+ * @param istream, the stream to read the values from, must outlive the
+ * stream of values
+ * @param options, opt-in behaviours of the tokenizer
+ * @returns the stream of values
+ */
+template <typename CharT = char>
+parser::IstreamDocumentStream<CharT> parse_documents(
+    std::basic_istream<CharT> &istream, const token::Options &options = {});
+
+/**
+ * @brief Parse a text of one json value per line using the threads of a
+ * pool, see `parser::ParseLines`
+ * @param str_view, the string view to parse the values from
+ * @param pool, the threads to parse with
+ * @param callback, called on the calling thread with every value
+ * @param options, how the lines are read
+ * @returns the number of values and of malformed lines, and the error
+ */
+template <typename CharT = char, typename CallbackT>
+parser::LinesReport parse_lines(std::basic_string_view<CharT> str_view,
+                                utils::ThreadPool &pool, CallbackT &&callback,
+                                const parser::LinesOptions &options = {});
+
+/**
+ * @brief Parse a text of one json value per line into a queue, which is
+ * closed once all the values are pushed
+ * @param str_view, the string view to parse the values from
+ * @param pool, the threads to parse with
+ * @param queue, the queue to push the values to, read by another thread
+ * @param options, how the lines are read
+ * @returns the number of values and of malformed lines, and the error
+ */
+template <typename CharT = char>
+parser::LinesReport parse_lines(std::basic_string_view<CharT> str_view,
+                                utils::ThreadPool &pool,
+                                utils::BoundedQueue<BasicValue<CharT>> &queue,
+                                const parser::LinesOptions &options = {});
 
 /**
  * @brief UTF8 Value
@@ -28,27 +214,254 @@ using Value = BasicValue<char>;
  * @brief UTF8 Key
  */
 using Key = BasicKey<char>;
+
+/**
+ * @brief UTF8 document navigated without being parsed
+ */
+using LazyDocument = BasicLazyDocument<char>;
+
+/**
+ * @brief Error returned by `try_parse`
+ */
+using ParseError = parser::ParseError;
+
+/**
+ * @brief Parse json value from a file, the file is mapped into memory and
+ * tokenized in place instead of being read through a stream
+ * @param path, path to the file
+ * @returns the value, null if the file cannot be opened
+ */
+Value parse_file(const char *path);
 }  // namespace json
 
 namespace json {
 template <typename CharT>
-BasicValue<CharT> parse(std::basic_istream<CharT> &istream) {
-  token::Tokenizer<CharT> tokenizer{istream};
-  parser::Parser<CharT> parser;
+BasicValue<CharT> parse(std::basic_istream<CharT> &istream,
+                        const token::Options &options) {
+  token::CompactTokenizer<CharT, token::StreamInput<CharT>> tokenizer{
+      istream, options};
+  parser::Parser<CharT, token::CompactToken<CharT>> parser;
+
+  while (!tokenizer.Done() && parser.error() == utils::ErrorCode::kNone) {
+    tokenizer.Extract();
+    parser.take(tokenizer.token());
+  }
+
+  return parser.TakeRoot();
+}
+
+template <typename CharT>
+BasicValue<CharT> parse(const CharT *begin, const CharT *end,
+                        const token::Options &options) {
+  token::CompactTokenizer<CharT> tokenizer{{begin, end}, options};
+  parser::Parser<CharT, token::CompactToken<CharT>> parser;
+
+  while (!tokenizer.Done() && parser.error() == utils::ErrorCode::kNone) {
+    tokenizer.Extract();
+    parser.take(tokenizer.token());
+  }
+
+  return parser.TakeRoot();
+}
+
+template <typename CharT>
+BasicValue<CharT> parse(std::basic_string_view<CharT> str_view,
+                        const token::Options &options) {
+  return parse(str_view.data(), str_view.data() + str_view.size(), options);
+}
+
+template <typename CharT>
+BasicValue<CharT> parse(const parser::Tape<CharT> &tape) {
+  if (tape.size() == 0) {
+    return {};
+  }
+
+  size_t index = 0;
+  return parser::FromTape(tape, index);
+}
+
+template <typename CharT>
+BasicValue<CharT> parse_utf8(const char *begin, const char *end,
+                             const token::Options &options) {
+  token::Options bytes = options;
+  bytes.lazy_numbers = false;
+
+  token::CompactTokenizer<char> tokenizer{{begin, end}, bytes};
+  token::TranscodedToken<CharT> token;
+  parser::Parser<CharT, token::TranscodedToken<CharT>> parser;
+
+  while (!tokenizer.Done() && parser.error() == utils::ErrorCode::kNone) {
+    tokenizer.Extract();
+    token.Assign(tokenizer.token());
+    parser.take(token);
+  }
+
+  return parser.TakeRoot();
+}
+
+template <typename CharT>
+BasicValue<CharT> parse_utf8(std::string_view str_view,
+                             const token::Options &options) {
+  return parse_utf8<CharT>(str_view.data(), str_view.data() + str_view.size(),
+                           options);
+}
+
+template <typename CharT>
+BasicValue<CharT> parse_parallel(std::basic_string_view<CharT> str_view,
+                                 utils::ThreadPool &pool,
+                                 const token::Options &options) {
+  return parser::ParseParallel(str_view.data(),
+                               str_view.data() + str_view.size(), pool,
+                               options);
+}
+
+template <typename CharT>
+parser::DocumentStream<CharT> parse_documents(
+    std::basic_string_view<CharT> str_view, const token::Options &options) {
+  return {{str_view.data(), str_view.data() + str_view.size()}, options};
+}
+
+template <typename CharT>
+parser::IstreamDocumentStream<CharT> parse_documents(
+    std::basic_istream<CharT> &istream, const token::Options &options) {
+  return {istream, options};
+}
+
+template <typename CharT, typename CallbackT>
+parser::LinesReport parse_lines(std::basic_string_view<CharT> str_view,
+                                utils::ThreadPool &pool, CallbackT &&callback,
+                                const parser::LinesOptions &options) {
+  return parser::ParseLines(str_view.data(),
+                            str_view.data() + str_view.size(), pool,
+                            std::forward<CallbackT>(callback), options);
+}
+
+template <typename CharT>
+parser::LinesReport parse_lines(std::basic_string_view<CharT> str_view,
+                                utils::ThreadPool &pool,
+                                utils::BoundedQueue<BasicValue<CharT>> &queue,
+                                const parser::LinesOptions &options) {
+  parser::LinesReport report = parse_lines(
+      str_view, pool,
+      [&queue](BasicValue<CharT> &&value) { queue.Push(std::move(value)); },
+      options);
+
+  queue.Close();
+  return report;
+}
+
+namespace detail {
+/**
+ * @brief Feed the tokens of a tokenizer to a parser until the value is
+ * complete or an error is found
+ */
+template <typename CharT, typename TokenizerT>
+utils::Result<BasicValue<CharT>, parser::ParseError> TryParse(
+    TokenizerT &tokenizer) {
+  using Error = parser::ParseError;
+
+  parser::Parser<CharT, typename TokenizerT::TokenType> parser;
 
   while (!tokenizer.Done()) {
     tokenizer.Extract();
     parser.take(tokenizer.token());
+
+    if (parser.error() != utils::ErrorCode::kNone) {
+      return utils::Error<BasicValue<CharT>, Error>(
+          Error{parser.error(), tokenizer.offset()});
+    }
+  }
+
+  if (tokenizer.error() != utils::ErrorCode::kNone) {
+    return utils::Error<BasicValue<CharT>, Error>(
+        Error{tokenizer.error(), tokenizer.offset()});
   }
 
-  return parser.root();
+  if (!parser.done()) {
+    return utils::Error<BasicValue<CharT>, Error>(
+        Error{utils::ErrorCode::kUnexpectedEnd, tokenizer.offset()});
+  }
+
+  return utils::Ok<BasicValue<CharT>, Error>(parser.TakeRoot());
+}
+
+/**
+ * @brief Feed the tokens of a tokenizer to a grammar that calls a handler,
+ * until the value is complete or an error is found
+ */
+template <typename CharT, typename TokenizerT, typename HandlerT>
+parser::ParseError Sax(TokenizerT &tokenizer, HandlerT &handler) {
+  using Error = parser::ParseError;
+
+  parser::Grammar<CharT, typename TokenizerT::TokenType> grammar;
+
+  while (!tokenizer.Done()) {
+    tokenizer.Extract();
+    grammar.take(tokenizer.token(), handler);
+
+    if (grammar.error() != utils::ErrorCode::kNone) {
+      return Error{grammar.error(), tokenizer.offset()};
+    }
+  }
+
+  if (tokenizer.error() != utils::ErrorCode::kNone) {
+    return Error{tokenizer.error(), tokenizer.offset()};
+  }
+
+  if (!grammar.done()) {
+    return Error{utils::ErrorCode::kUnexpectedEnd, tokenizer.offset()};
+  }
+
+  return Error{};
+}
+}  // namespace detail
+
+template <typename CharT>
+utils::Result<BasicValue<CharT>, parser::ParseError> try_parse(
+    const CharT *begin, const CharT *end, const token::Options &options) {
+  token::CompactTokenizer<CharT> tokenizer{{begin, end}, options};
+  return detail::TryParse<CharT>(tokenizer);
+}
+
+template <typename CharT>
+utils::Result<BasicValue<CharT>, parser::ParseError> try_parse(
+    std::basic_string_view<CharT> str_view, const token::Options &options) {
+  return try_parse(str_view.data(), str_view.data() + str_view.size(),
+                   options);
 }
 
 template <typename CharT>
-BasicValue<CharT> parse(std::basic_string_view<CharT> &str_view) {
-  std::stringstream ss;
-  ss << str_view;
+utils::Result<BasicValue<CharT>, parser::ParseError> try_parse(
+    std::basic_istream<CharT> &istream, const token::Options &options) {
+  token::CompactTokenizer<CharT, token::StreamInput<CharT>> tokenizer{
+      istream, options};
+  return detail::TryParse<CharT>(tokenizer);
+}
+
+template <typename CharT, typename HandlerT>
+parser::ParseError parse_sax(std::basic_string_view<CharT> str_view,
+                             HandlerT &handler, const token::Options &options) {
+  token::CompactTokenizer<CharT> tokenizer{str_view, options};
+  return detail::Sax<CharT>(tokenizer, handler);
+}
 
-  return parse(ss);
+template <typename CharT, typename HandlerT>
+parser::ParseError parse_sax(std::basic_istream<CharT> &istream,
+                             HandlerT &handler, const token::Options &options) {
+  token::CompactTokenizer<CharT, token::StreamInput<CharT>> tokenizer{
+      istream, options};
+  return detail::Sax<CharT>(tokenizer, handler);
 }
-}  // namespace json
\ No newline at end of file
+
+inline Value parse_file(const char *path) {
+  utils::MappedFile file{path};
+
+  if (!file.is_open()) {
+    return {};
+  }
+
+  // strings are copied into the value, and lazy numbers are not used, so the
+  // value does not reference the mapping
+  return parse(file.begin(), file.end());
+}
+}  // namespace json
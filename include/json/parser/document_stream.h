@@ -0,0 +1,234 @@
+#pragma once
+
+#include <stddef.h>
+#include <iterator>
+#include "json/parser/parse_error.h"
+#include "json/parser/parser.h"
+#include "json/token/input.h"
+#include "json/token/options.h"
+#include "json/token/tokenizer.h"
+#include "json/utils/error_code.h"
+#include "json/value/basic_value.h"
+
+namespace json::parser {
+/**
+ * @brief Read the values of a text made of json values one after another,
+ * separated by whitespaces or by the record separators of RFC 7464
+ *
+ * One tokenizer reads the whole text and one parser builds all the values,
+ * so their buffers are reused from one value to the next. The values are
+ * read from a contiguous range by default, use `token::StreamInput` to read
+ * from a stream.
+ */
+template <typename CharT, typename InputT = token::BufferInput<CharT>>
+class DocumentStream {
+ public:
+  /**
+   * @brief Input iterator over the values that are left, the value it points
+   * to can be moved out
+   */
+  class Iterator {
+   public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = BasicValue<CharT>;
+    using difference_type = ptrdiff_t;
+    using pointer = BasicValue<CharT> *;
+    using reference = BasicValue<CharT> &;
+
+    /**
+     * @brief Create an iterator over the values of a stream, or the end
+     * iterator if the stream is `nullptr`
+     */
+    explicit Iterator(DocumentStream *stream = nullptr);
+
+    reference operator*() const;
+    pointer operator->() const;
+
+    /**
+     * @brief Read the next value, the iterator becomes the end iterator once
+     * there is none or an error is found
+     */
+    Iterator &operator++();
+
+    bool operator==(const Iterator &other) const;
+    bool operator!=(const Iterator &other) const;
+
+   private:
+    DocumentStream *stream_;
+  };
+
+  /**
+   * @brief Create a stream of values
+   * @param input the input to read from, a range for the default input
+   * @param options opt-in behaviours of the tokenizer, record separators are
+   * always skipped
+   */
+  DocumentStream(InputT input, const token::Options &options = {});
+
+  /**
+   * @brief Read the next value
+   * @returns `true` if a value was read, `false` at the end of the text or
+   * once an error is found
+   */
+  bool Next();
+
+  /**
+   * @brief Get the last value read, which can be moved out
+   * @returns a reference to the value
+   */
+  BasicValue<CharT> &value();
+
+  /**
+   * @brief Get the error that stopped the stream
+   * @returns the error, its code is `kNone` if there is none
+   */
+  const ParseError &error() const;
+
+  /**
+   * @brief Read the first value and get an iterator to it, can only be
+   * called once
+   */
+  Iterator begin();
+
+  /**
+   * @brief Get the end iterator
+   */
+  Iterator end();
+
+ private:
+  using TokenizerType = token::CompactTokenizer<CharT, InputT>;
+
+  TokenizerType tokenizer_;
+  Parser<CharT, typename TokenizerType::TokenType> parser_;
+  BasicValue<CharT> value_;
+  ParseError error_;
+};
+
+/**
+ * @brief Stream of values read from a `std::basic_istream`
+ */
+template <typename CharT>
+using IstreamDocumentStream = DocumentStream<CharT, token::StreamInput<CharT>>;
+}  // namespace json::parser
+
+// Implementations
+
+namespace json::parser {
+namespace detail {
+/**
+ * @brief Copy options, turning on the record separators
+ */
+inline token::Options WithRecordSeparators(const token::Options &options) {
+  token::Options copy = options;
+  copy.record_separators = true;
+
+  return copy;
+}
+}  // namespace detail
+
+template <typename CharT, typename InputT>
+DocumentStream<CharT, InputT>::Iterator::Iterator(DocumentStream *stream)
+    : stream_(stream) {}
+
+template <typename CharT, typename InputT>
+typename DocumentStream<CharT, InputT>::Iterator::reference
+    DocumentStream<CharT, InputT>::Iterator::operator*() const {
+  return stream_->value();
+}
+
+template <typename CharT, typename InputT>
+typename DocumentStream<CharT, InputT>::Iterator::pointer
+    DocumentStream<CharT, InputT>::Iterator::operator->() const {
+  return &stream_->value();
+}
+
+template <typename CharT, typename InputT>
+typename DocumentStream<CharT, InputT>::Iterator &
+DocumentStream<CharT, InputT>::Iterator::operator++() {
+  if (!stream_->Next()) {
+    stream_ = nullptr;
+  }
+
+  return *this;
+}
+
+template <typename CharT, typename InputT>
+bool DocumentStream<CharT, InputT>::Iterator::operator==(
+    const Iterator &other) const {
+  return stream_ == other.stream_;
+}
+
+template <typename CharT, typename InputT>
+bool DocumentStream<CharT, InputT>::Iterator::operator!=(
+    const Iterator &other) const {
+  return stream_ != other.stream_;
+}
+
+template <typename CharT, typename InputT>
+DocumentStream<CharT, InputT>::DocumentStream(InputT input,
+                                              const token::Options &options)
+    : tokenizer_(input, detail::WithRecordSeparators(options)) {}
+
+template <typename CharT, typename InputT>
+bool DocumentStream<CharT, InputT>::Next() {
+  using TType = typename TokenizerType::TokenType::Type;
+
+  if (error_.code != utils::ErrorCode::kNone) {
+    return false;
+  }
+
+  parser_.Reset();
+  bool started = false;
+
+  while (!tokenizer_.Done()) {
+    tokenizer_.Extract();
+
+    TType type = tokenizer_.token().type;
+    started = started ||
+              (type != TType::kUninitialized && type != TType::kComment);
+
+    parser_.take(tokenizer_.token());
+
+    if (parser_.error() != utils::ErrorCode::kNone) {
+      error_ = ParseError{parser_.error(), tokenizer_.offset()};
+      return false;
+    }
+
+    // stop right after the value, the tokens after it start the next one
+    if (parser_.done()) {
+      value_ = parser_.TakeRoot();
+      return true;
+    }
+  }
+
+  if (tokenizer_.error() != utils::ErrorCode::kNone) {
+    error_ = ParseError{tokenizer_.error(), tokenizer_.offset()};
+  } else if (started) {
+    error_ = ParseError{utils::ErrorCode::kUnexpectedEnd, tokenizer_.offset()};
+  }
+
+  return false;
+}
+
+template <typename CharT, typename InputT>
+BasicValue<CharT> &DocumentStream<CharT, InputT>::value() {
+  return value_;
+}
+
+template <typename CharT, typename InputT>
+const ParseError &DocumentStream<CharT, InputT>::error() const {
+  return error_;
+}
+
+template <typename CharT, typename InputT>
+typename DocumentStream<CharT, InputT>::Iterator
+DocumentStream<CharT, InputT>::begin() {
+  return Iterator{Next() ? this : nullptr};
+}
+
+template <typename CharT, typename InputT>
+typename DocumentStream<CharT, InputT>::Iterator
+DocumentStream<CharT, InputT>::end() {
+  return Iterator{};
+}
+}  // namespace json::parser
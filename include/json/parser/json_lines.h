@@ -0,0 +1,289 @@
+#pragma once
+
+#include <stddef.h>
+#include <algorithm>
+#include <exception>
+#include <map>
+#include <utility>
+#include <vector>
+#include "json/parser/parse_error.h"
+#include "json/parser/parser.h"
+#include "json/token/compact_token.h"
+#include "json/token/options.h"
+#include "json/token/tokenizer.h"
+#include "json/utils/bounded_queue.h"
+#include "json/utils/char_class.h"
+#include "json/utils/error_code.h"
+#include "json/utils/letters.h"
+#include "json/utils/thread_pool.h"
+#include "json/value/basic_value.h"
+
+namespace json::parser {
+/**
+ * @brief How the lines of a json lines text are read
+ */
+struct LinesOptions {
+  /**
+   * @brief Hand the values to the callback in the order of their lines
+   *
+   * When disabled, the values of a batch of lines are handed over as soon as
+   * the batch is parsed, which may be before the batches that come first.
+   */
+  bool ordered = true;
+
+  /**
+   * @brief Count lines that are not valid and go on, instead of stopping at
+   * the first one
+   */
+  bool skip_malformed = false;
+
+  /**
+   * @brief Number of letters given to a task, rounded up to a whole line
+   */
+  size_t batch = size_t{1} << 16;
+
+  /**
+   * @brief Opt-in behaviours of the tokenizer
+   */
+  token::Options token;
+};
+
+/**
+ * @brief What was found in a json lines text
+ */
+struct LinesReport {
+  /**
+   * @brief Number of values handed to the callback
+   */
+  size_t records = 0;
+
+  /**
+   * @brief Number of lines skipped because they are not valid
+   */
+  size_t malformed = 0;
+
+  /**
+   * @brief The line that stopped the reading, offset from the start of the
+   * text; its code is `kNone` if all the lines were read
+   */
+  ParseError error;
+};
+
+/**
+ * @brief Parse a text made of one json value per line using the threads of a
+ * pool
+ *
+ * The text is cut into batches of whole lines, which are parsed as tasks of
+ * the pool. The callback is only called on the calling thread, with the
+ * value of every line that is not blank. A limited number of batches is in
+ * flight at once, so the memory used does not grow with the text.
+ *
+ * Unless malformed lines are skipped, the first line that is not valid stops
+ * the reading and no value is handed over after it. When the values are not
+ * ordered, values of the lines after it may have been handed over before.
+ *
+ * If the callback throws, no value is handed over after it and the exception
+ * is rethrown once every task of the reading has finished.
+ *
+ * @param begin pointer to the first letter of the text
+ * @param end pointer past the last letter of the text
+ * @param pool the threads to parse with
+ * @param callback called with every value as `BasicValue<CharT> &&`
+ * @param options how the lines are read
+ * @returns the number of values and of malformed lines, and the error
+ */
+template <typename CharT, typename CallbackT>
+LinesReport ParseLines(const CharT *begin, const CharT *end,
+                       utils::ThreadPool &pool, CallbackT &&callback,
+                       const LinesOptions &options = {});
+}  // namespace json::parser
+
+// Implementations
+
+namespace json::parser {
+namespace detail {
+/**
+ * @brief Values of a batch of lines
+ */
+template <typename CharT>
+struct LinesBatch {
+  size_t index = 0;
+  std::vector<BasicValue<CharT>> values;
+  size_t malformed = 0;
+  ParseError error;
+};
+
+/**
+ * @brief See if a line only has whitespaces
+ */
+template <typename CharT>
+bool IsBlank(const CharT *begin, const CharT *end) {
+  using utils::char_class::Dispatch;
+
+  return std::all_of(begin, end, [](CharT letter) {
+    return utils::char_class::Lookup(letter).dispatch == Dispatch::kWhitespace;
+  });
+}
+
+/**
+ * @brief Parse the value of a line
+ * @param parser the parser to reuse, reset before the line is parsed
+ * @param value set to the value if the line is valid
+ * @returns the error, offset from the start of the line
+ */
+template <typename CharT>
+ParseError ParseLine(const CharT *begin, const CharT *end,
+                     const token::Options &options,
+                     Parser<CharT, token::CompactToken<CharT>> &parser,
+                     BasicValue<CharT> &value) {
+  token::CompactTokenizer<CharT> tokenizer{{begin, end}, options};
+  parser.Reset();
+
+  while (!tokenizer.Done()) {
+    tokenizer.Extract();
+    parser.take(tokenizer.token());
+
+    if (parser.error() != utils::ErrorCode::kNone) {
+      return ParseError{parser.error(), tokenizer.offset()};
+    }
+  }
+
+  if (tokenizer.error() != utils::ErrorCode::kNone) {
+    return ParseError{tokenizer.error(), tokenizer.offset()};
+  }
+
+  if (!parser.done()) {
+    return ParseError{utils::ErrorCode::kUnexpectedEnd, tokenizer.offset()};
+  }
+
+  value = parser.TakeRoot();
+  return ParseError{};
+}
+
+/**
+ * @brief Parse the lines of [first, last)
+ * @param begin pointer to the first letter of the text, to offset errors
+ */
+template <typename CharT>
+LinesBatch<CharT> ParseBatch(const CharT *begin, const CharT *first,
+                             const CharT *last, const LinesOptions &options) {
+  LinesBatch<CharT> batch;
+  Parser<CharT, token::CompactToken<CharT>> parser;
+
+  while (first != last) {
+    const CharT *line_end =
+        std::find(first, last, utils::letters::kEndline<CharT>);
+
+    if (!IsBlank(first, line_end)) {
+      BasicValue<CharT> value;
+      ParseError error =
+          ParseLine(first, line_end, options.token, parser, value);
+
+      if (error.code == utils::ErrorCode::kNone) {
+        batch.values.push_back(std::move(value));
+      } else if (options.skip_malformed) {
+        ++batch.malformed;
+      } else {
+        error.offset += size_t(first - begin);
+        batch.error = error;
+        return batch;
+      }
+    }
+
+    first = line_end == last ? last : line_end + 1;
+  }
+
+  return batch;
+}
+}  // namespace detail
+
+template <typename CharT, typename CallbackT>
+LinesReport ParseLines(const CharT *begin, const CharT *end,
+                       utils::ThreadPool &pool, CallbackT &&callback,
+                       const LinesOptions &options) {
+  using Batch = detail::LinesBatch<CharT>;
+
+  // the batches in flight, parsed or not, fit in the queue, so the tasks
+  // never wait to push
+  const size_t limit = 2 * pool.size();
+  utils::BoundedQueue<Batch> parsed{limit};
+  std::map<size_t, Batch> waiting;
+
+  LinesReport report;
+  const CharT *cursor = begin;
+  size_t submitted = 0;
+  size_t delivered = 0;
+  bool stopped = false;
+  std::exception_ptr failure;
+
+  const auto deliver = [&](Batch &batch) {
+    ++delivered;
+
+    if (stopped) {
+      return;
+    }
+
+    report.records += batch.values.size();
+    report.malformed += batch.malformed;
+
+    try {
+      for (BasicValue<CharT> &value : batch.values) {
+        callback(std::move(value));
+      }
+    } catch (...) {
+      // the tasks still in flight push to `parsed`, so they are drained
+      // before the exception leaves
+      failure = std::current_exception();
+      stopped = true;
+      return;
+    }
+
+    if (batch.error.code != utils::ErrorCode::kNone) {
+      report.error = batch.error;
+      stopped = true;
+    }
+  };
+
+  while (delivered != submitted || (cursor != end && !stopped)) {
+    if (cursor != end && !stopped && submitted - delivered < limit) {
+      const CharT *first = cursor;
+      const CharT *last =
+          first + std::min(options.batch, size_t(end - first));
+
+      last = std::find(last, end, utils::letters::kEndline<CharT>);
+      last = last == end ? end : last + 1;
+
+      pool.Submit([&parsed, &options, begin, first, last, submitted]() {
+        Batch batch = detail::ParseBatch(begin, first, last, options);
+        batch.index = submitted;
+        parsed.Push(std::move(batch));
+      });
+
+      cursor = last;
+      ++submitted;
+      continue;
+    }
+
+    Batch batch = std::move(*parsed.Pop());
+
+    if (!options.ordered) {
+      deliver(batch);
+      continue;
+    }
+
+    waiting.emplace(batch.index, std::move(batch));
+
+    for (auto next = waiting.find(delivered); next != waiting.end();
+         next = waiting.find(delivered)) {
+      deliver(next->second);
+      waiting.erase(next);
+    }
+  }
+
+  if (failure) {
+    std::rethrow_exception(failure);
+  }
+
+  return report;
+}
+}  // namespace json::parser
@@ -0,0 +1,353 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string_view>
+#include "json/parser/parse_error.h"
+#include "json/parser/sax.h"
+#include "json/token/input.h"
+#include "json/token/options.h"
+#include "json/token/tokenizer.h"
+#include "json/utils/convert.h"
+#include "json/utils/error_code.h"
+
+namespace json::parser {
+/**
+ * @brief What a `JsonReader` found
+ */
+enum class ReaderEvent : uint8_t {
+  /**
+   * @brief Nothing was read yet
+   */
+  kNone,
+  kStartObject,
+  kKey,
+  kEndObject,
+  kStartArray,
+  kEndArray,
+  kString,
+  kNumber,
+  kBool,
+  kNull,
+  /**
+   * @brief The value is complete and the input is exhausted
+   */
+  kEnd,
+  /**
+   * @brief The input is not valid json, see `JsonReader::error`
+   */
+  kError,
+};
+
+/**
+ * @brief Read a json value one event at a time, the caller decides what to
+ * read and what to skip
+ *
+ * The tokens are checked by the same `Grammar` as `Parser`, no value is
+ * built. The letters of keys and strings are only valid until the next
+ * event is read. Once an error is found, every read returns `kError`.
+ *
+ * The values are read from a contiguous range by default, use
+ * `token::StreamInput` to read from a stream.
+ */
+template <typename CharT, typename InputT = token::BufferInput<CharT>>
+class JsonReader {
+ public:
+  using Event = ReaderEvent;
+
+  /**
+   * @brief Create a reader
+   * @param input the input to read from, a range for the default input
+   * @param options opt-in behaviours of the tokenizer
+   */
+  JsonReader(InputT input, const token::Options &options = {});
+
+  /**
+   * @brief Read the next event
+   * @returns the event
+   */
+  Event Next();
+
+  /**
+   * @brief Skip the next value, with all of its members or elements when it
+   * is an object or an array, without building it
+   * @returns `true` on success, `false` if the next event does not start a
+   * value, which is an error
+   */
+  bool SkipValue();
+
+  /**
+   * @brief Read the next value, which must be a string
+   * @returns the letters of the string, valid until the next read, empty if
+   * the next value is not a string, which is an error
+   */
+  std::basic_string_view<CharT> ReadString();
+
+  /**
+   * @brief Read the next value, which must be a number
+   * @returns the number, 0 if the next value is not a number, which is an
+   * error
+   */
+  utils::convert::number::Value ReadNumber();
+
+  /**
+   * @brief Get the number of objects and arrays that are open
+   */
+  size_t Depth() const;
+
+  /**
+   * @brief Get the last event read
+   */
+  Event event() const;
+
+  /**
+   * @brief Get the letters of the last key or string read, valid until the
+   * next read
+   */
+  std::basic_string_view<CharT> string() const;
+
+  /**
+   * @brief Get the last number read
+   */
+  const SaxNumber<CharT> &number() const;
+
+  /**
+   * @brief Get the last boolean read
+   */
+  bool boolean() const;
+
+  /**
+   * @brief Get the error that stopped the reader
+   * @returns the error, its code is `kNone` if there is none
+   */
+  const ParseError &error() const;
+
+ private:
+  /**
+   * @brief Handler that records the event of a token
+   */
+  struct Recorder {
+    void StartObject();
+    void Key(std::basic_string_view<CharT> key);
+    void EndObject();
+    void StartArray();
+    void EndArray();
+    void String(std::basic_string_view<CharT> string);
+    void Number(const SaxNumber<CharT> &number);
+    void Bool(bool boolean);
+    void Null();
+
+    Event event = Event::kNone;
+    std::basic_string_view<CharT> string;
+    SaxNumber<CharT> number{utils::convert::number::Value{}};
+    bool boolean = false;
+    size_t depth = 0;
+  };
+
+  using TokenizerType = token::CompactTokenizer<CharT, InputT>;
+
+  /**
+   * @brief Record an error, after which every read returns `kError`
+   */
+  void Fail(utils::ErrorCode error);
+
+  TokenizerType tokenizer_;
+  Grammar<CharT, typename TokenizerType::TokenType> grammar_;
+  Recorder recorder_;
+  ParseError error_;
+};
+
+/**
+ * @brief Reader of a value read from a `std::basic_istream`
+ */
+template <typename CharT>
+using IstreamJsonReader = JsonReader<CharT, token::StreamInput<CharT>>;
+}  // namespace json::parser
+
+// Implementations
+
+namespace json::parser {
+template <typename CharT, typename InputT>
+void JsonReader<CharT, InputT>::Recorder::StartObject() {
+  event = Event::kStartObject;
+  ++depth;
+}
+
+template <typename CharT, typename InputT>
+void JsonReader<CharT, InputT>::Recorder::Key(
+    std::basic_string_view<CharT> key) {
+  event = Event::kKey;
+  string = key;
+}
+
+template <typename CharT, typename InputT>
+void JsonReader<CharT, InputT>::Recorder::EndObject() {
+  event = Event::kEndObject;
+  --depth;
+}
+
+template <typename CharT, typename InputT>
+void JsonReader<CharT, InputT>::Recorder::StartArray() {
+  event = Event::kStartArray;
+  ++depth;
+}
+
+template <typename CharT, typename InputT>
+void JsonReader<CharT, InputT>::Recorder::EndArray() {
+  event = Event::kEndArray;
+  --depth;
+}
+
+template <typename CharT, typename InputT>
+void JsonReader<CharT, InputT>::Recorder::String(
+    std::basic_string_view<CharT> letters) {
+  event = Event::kString;
+  string = letters;
+}
+
+template <typename CharT, typename InputT>
+void JsonReader<CharT, InputT>::Recorder::Number(
+    const SaxNumber<CharT> &value) {
+  event = Event::kNumber;
+  number = value;
+}
+
+template <typename CharT, typename InputT>
+void JsonReader<CharT, InputT>::Recorder::Bool(bool value) {
+  event = Event::kBool;
+  boolean = value;
+}
+
+template <typename CharT, typename InputT>
+void JsonReader<CharT, InputT>::Recorder::Null() {
+  event = Event::kNull;
+}
+
+template <typename CharT, typename InputT>
+JsonReader<CharT, InputT>::JsonReader(InputT input,
+                                      const token::Options &options)
+    : tokenizer_(input, options) {}
+
+template <typename CharT, typename InputT>
+typename JsonReader<CharT, InputT>::Event JsonReader<CharT, InputT>::Next() {
+  if (recorder_.event == Event::kError || recorder_.event == Event::kEnd) {
+    return recorder_.event;
+  }
+
+  // separators and comments make no event, read until a token does
+  recorder_.event = Event::kNone;
+
+  while (recorder_.event == Event::kNone) {
+    if (tokenizer_.Done()) {
+      if (tokenizer_.error() != utils::ErrorCode::kNone) {
+        Fail(tokenizer_.error());
+      } else if (!grammar_.done()) {
+        Fail(utils::ErrorCode::kUnexpectedEnd);
+      } else {
+        recorder_.event = Event::kEnd;
+      }
+
+      break;
+    }
+
+    tokenizer_.Extract();
+    grammar_.take(tokenizer_.token(), recorder_);
+
+    if (grammar_.error() != utils::ErrorCode::kNone) {
+      Fail(grammar_.error());
+    }
+  }
+
+  return recorder_.event;
+}
+
+template <typename CharT, typename InputT>
+bool JsonReader<CharT, InputT>::SkipValue() {
+  switch (Next()) {
+    case Event::kStartObject:
+    case Event::kStartArray: {
+      // the grammar makes sure that every object and array is closed
+      size_t depth = recorder_.depth - 1;
+
+      while (recorder_.depth != depth) {
+        if (Next() == Event::kError) {
+          return false;
+        }
+      }
+
+      return true;
+    }
+    case Event::kString:
+    case Event::kNumber:
+    case Event::kBool:
+    case Event::kNull:
+      return true;
+    case Event::kError:
+      return false;
+    default:
+      Fail(utils::ErrorCode::kUnexpectedToken);
+      return false;
+  }
+}
+
+template <typename CharT, typename InputT>
+std::basic_string_view<CharT> JsonReader<CharT, InputT>::ReadString() {
+  if (Next() != Event::kString) {
+    Fail(utils::ErrorCode::kUnexpectedToken);
+    return {};
+  }
+
+  return recorder_.string;
+}
+
+template <typename CharT, typename InputT>
+utils::convert::number::Value JsonReader<CharT, InputT>::ReadNumber() {
+  if (Next() != Event::kNumber) {
+    Fail(utils::ErrorCode::kUnexpectedToken);
+    return {};
+  }
+
+  return recorder_.number.value();
+}
+
+template <typename CharT, typename InputT>
+size_t JsonReader<CharT, InputT>::Depth() const {
+  return recorder_.depth;
+}
+
+template <typename CharT, typename InputT>
+typename JsonReader<CharT, InputT>::Event JsonReader<CharT, InputT>::event()
+    const {
+  return recorder_.event;
+}
+
+template <typename CharT, typename InputT>
+std::basic_string_view<CharT> JsonReader<CharT, InputT>::string() const {
+  return recorder_.string;
+}
+
+template <typename CharT, typename InputT>
+const SaxNumber<CharT> &JsonReader<CharT, InputT>::number() const {
+  return recorder_.number;
+}
+
+template <typename CharT, typename InputT>
+bool JsonReader<CharT, InputT>::boolean() const {
+  return recorder_.boolean;
+}
+
+template <typename CharT, typename InputT>
+const ParseError &JsonReader<CharT, InputT>::error() const {
+  return error_;
+}
+
+template <typename CharT, typename InputT>
+void JsonReader<CharT, InputT>::Fail(utils::ErrorCode error) {
+  // the first error is kept
+  if (error_.code == utils::ErrorCode::kNone) {
+    error_ = ParseError{error, tokenizer_.offset()};
+  }
+
+  recorder_.event = Event::kError;
+}
+}  // namespace json::parser
@@ -0,0 +1,453 @@
+#pragma once
+
+#include <stddef.h>
+#include <algorithm>
+#include <future>
+#include <utility>
+#include <vector>
+#include "json/parser/parser.h"
+#include "json/token/compact_token.h"
+#include "json/token/options.h"
+#include "json/token/tokenizer.h"
+#include "json/utils/char_class.h"
+#include "json/utils/error_code.h"
+#include "json/utils/letters.h"
+#include "json/utils/thread_pool.h"
+#include "json/value/basic_value.h"
+
+namespace json::parser {
+/**
+ * @brief Smallest number of letters given to a thread, smaller texts are
+ * parsed on the calling thread
+ */
+inline constexpr size_t kParallelChunk = size_t{1} << 16;
+
+/**
+ * @brief Parse a text whose value is an array or an object using the threads
+ * of a pool
+ *
+ * The text between the brackets of the value is cut into one chunk per
+ * thread. A first pass counts the quotes of every chunk so that whether a
+ * chunk starts inside a string is known, a second pass counts the brackets
+ * of every chunk so that its depth is known. Every chunk is then moved to the
+ * first separator of the value that follows it, and the elements or members
+ * between two separators are parsed on their own before being moved into the
+ * value in order.
+ *
+ * Texts that are small, that are not an array or an object, that allow
+ * comments or that are not valid are parsed on the calling thread instead,
+ * so the result is always the one of a serial parse.
+ *
+ * The calling thread waits for the tasks it submits, so it must not be a
+ * thread of the pool: once every thread of the pool waits, the tasks are
+ * never run and the parse deadlocks.
+ *
+ * @param begin pointer to the first letter of the text
+ * @param end pointer past the last letter of the text
+ * @param pool the threads to parse with
+ * @param options opt-in behaviours of the tokenizer
+ * @returns the value
+ */
+template <typename CharT>
+BasicValue<CharT> ParseParallel(const CharT *begin, const CharT *end,
+                                utils::ThreadPool &pool,
+                                const token::Options &options = {});
+}  // namespace json::parser
+
+// Implementations
+
+namespace json::parser {
+namespace detail {
+template <typename CharT>
+using TokenType = typename token::Token<CharT>::Type;
+
+/**
+ * @brief Tasks submitted to a pool that are all waited for, even when one of
+ * them throws, so that none of them outlives the locals it references
+ */
+template <typename T>
+class TaskGroup {
+ public:
+  explicit TaskGroup(utils::ThreadPool &pool);
+
+  TaskGroup(const TaskGroup &) = delete;
+  TaskGroup &operator=(const TaskGroup &) = delete;
+
+  /**
+   * @brief Wait for the tasks whose results were not taken
+   */
+  ~TaskGroup();
+
+  template <typename TaskT>
+  void Submit(TaskT &&task);
+
+  /**
+   * @brief Wait for all the tasks, then take their results in the order of
+   * submission
+   * @returns the results, the exception of the first task that threw is
+   * thrown instead
+   */
+  std::vector<T> Get();
+
+ private:
+  void Wait();
+
+  utils::ThreadPool &pool_;
+  std::vector<std::future<T>> futures_;
+};
+
+template <typename T>
+TaskGroup<T>::TaskGroup(utils::ThreadPool &pool) : pool_(pool) {}
+
+template <typename T>
+TaskGroup<T>::~TaskGroup() {
+  Wait();
+}
+
+template <typename T>
+template <typename TaskT>
+void TaskGroup<T>::Submit(TaskT &&task) {
+  futures_.push_back(pool_.Submit(std::forward<TaskT>(task)));
+}
+
+template <typename T>
+std::vector<T> TaskGroup<T>::Get() {
+  Wait();
+
+  std::vector<T> results;
+  results.reserve(futures_.size());
+
+  for (std::future<T> &future : futures_) {
+    results.push_back(future.get());
+  }
+
+  return results;
+}
+
+template <typename T>
+void TaskGroup<T>::Wait() {
+  for (std::future<T> &future : futures_) {
+    if (future.valid()) {
+      future.wait();
+    }
+  }
+}
+
+/**
+ * @brief Feed the tokens of [begin, end) to a parser, between an opening and
+ * a closing token unless they are uninitialized
+ * @returns `true` if the tokens make a whole value
+ */
+template <typename CharT>
+bool ParseRange(const CharT *begin, const CharT *end,
+                const token::Options &options, TokenType<CharT> open,
+                TokenType<CharT> close, BasicValue<CharT> &value) {
+  using TType = TokenType<CharT>;
+
+  token::CompactTokenizer<CharT> tokenizer{{begin, end}, options};
+  Parser<CharT, token::CompactToken<CharT>> parser;
+  token::CompactToken<CharT> bracket;
+
+  bracket.type = open;
+  parser.take(bracket);
+
+  while (!tokenizer.Done() && parser.error() == utils::ErrorCode::kNone) {
+    tokenizer.Extract();
+    parser.take(tokenizer.token());
+  }
+
+  bracket.type = close;
+  parser.take(bracket);
+
+  value = parser.TakeRoot();
+
+  if (open == TType::kUninitialized) {
+    return tokenizer.error() == utils::ErrorCode::kNone && parser.done();
+  }
+
+  // an empty part comes from a missing element or member
+  return tokenizer.error() == utils::ErrorCode::kNone && parser.done() &&
+         value.size() != 0;
+}
+
+/**
+ * @brief Count the quotes of a chunk that starts outside of an escape
+ * @returns `true` if the number of quotes is odd
+ */
+template <typename CharT>
+bool OddQuotes(const CharT *begin, const CharT *end) {
+  using namespace utils;
+
+  bool odd = false;
+
+  for (const CharT *cursor = begin; cursor != end; ++cursor) {
+    if (*cursor == letters::kBackSolidus<CharT>) {
+      ++cursor;
+
+      if (cursor == end) {
+        break;
+      }
+    } else if (*cursor == letters::kDoubleQuote<CharT>) {
+      odd = !odd;
+    }
+  }
+
+  return odd;
+}
+
+/**
+ * @brief Count the brackets of a chunk that are not in strings
+ * @param in_string `true` if the chunk starts inside a string
+ * @returns the number of opening brackets minus the number of closing ones
+ */
+template <typename CharT>
+ptrdiff_t Depth(const CharT *begin, const CharT *end, bool in_string) {
+  using namespace utils;
+  using char_class::Dispatch;
+
+  ptrdiff_t depth = 0;
+
+  for (const CharT *cursor = begin; cursor != end; ++cursor) {
+    if (in_string) {
+      if (*cursor == letters::kBackSolidus<CharT>) {
+        ++cursor;
+
+        if (cursor == end) {
+          break;
+        }
+      } else if (*cursor == letters::kDoubleQuote<CharT>) {
+        in_string = false;
+      }
+
+      continue;
+    }
+
+    switch (char_class::Lookup(*cursor).dispatch) {
+      case Dispatch::kString:
+        in_string = true;
+        break;
+      case Dispatch::kBeginObject:
+      case Dispatch::kBeginArray:
+        ++depth;
+        break;
+      case Dispatch::kEndObject:
+      case Dispatch::kEndArray:
+        --depth;
+        break;
+      default:
+        break;
+    }
+  }
+
+  return depth;
+}
+
+/**
+ * @brief Find the first separator of the outermost value from a position
+ * @param in_string `true` if the position is inside a string
+ * @param depth depth of the position, 0 being directly inside the value
+ * @returns pointer to the separator, `end` if there is none
+ */
+template <typename CharT>
+const CharT *FindSeparator(const CharT *begin, const CharT *end,
+                           bool in_string, ptrdiff_t depth) {
+  using namespace utils;
+  using char_class::Dispatch;
+
+  for (const CharT *cursor = begin; cursor != end; ++cursor) {
+    if (in_string) {
+      if (*cursor == letters::kBackSolidus<CharT>) {
+        ++cursor;
+
+        if (cursor == end) {
+          break;
+        }
+      } else if (*cursor == letters::kDoubleQuote<CharT>) {
+        in_string = false;
+      }
+
+      continue;
+    }
+
+    switch (char_class::Lookup(*cursor).dispatch) {
+      case Dispatch::kString:
+        in_string = true;
+        break;
+      case Dispatch::kBeginObject:
+      case Dispatch::kBeginArray:
+        ++depth;
+        break;
+      case Dispatch::kEndObject:
+      case Dispatch::kEndArray:
+        --depth;
+        break;
+      case Dispatch::kValueSeparator:
+        if (depth == 0) {
+          return cursor;
+        }
+        break;
+      default:
+        break;
+    }
+  }
+
+  return end;
+}
+}  // namespace detail
+
+template <typename CharT>
+BasicValue<CharT> ParseParallel(const CharT *begin, const CharT *end,
+                                utils::ThreadPool &pool,
+                                const token::Options &options) {
+  using namespace utils;
+  using TType = detail::TokenType<CharT>;
+  using char_class::Dispatch;
+
+  const auto serial = [&]() {
+    BasicValue<CharT> value;
+    detail::ParseRange(begin, end, options, TType::kUninitialized,
+                       TType::kUninitialized, value);
+    return value;
+  };
+
+  // find the brackets of the value
+  const CharT *first = begin;
+  const CharT *last = end;
+
+  while (first != last &&
+         char_class::Lookup(*first).dispatch == Dispatch::kWhitespace) {
+    ++first;
+  }
+
+  while (last != first &&
+         char_class::Lookup(last[-1]).dispatch == Dispatch::kWhitespace) {
+    --last;
+  }
+
+  size_t chunks = std::min(pool.size(), size_t(end - begin) / kParallelChunk);
+
+  if (chunks < 2 || options.comments || last - first < 2) {
+    return serial();
+  }
+
+  Dispatch open = char_class::Lookup(*first).dispatch;
+  Dispatch close = char_class::Lookup(last[-1]).dispatch;
+  TType open_token;
+  TType close_token;
+
+  if (open == Dispatch::kBeginArray && close == Dispatch::kEndArray) {
+    open_token = TType::kBeginArray;
+    close_token = TType::kEndArray;
+  } else if (open == Dispatch::kBeginObject && close == Dispatch::kEndObject) {
+    open_token = TType::kBeginObject;
+    close_token = TType::kEndObject;
+  } else {
+    return serial();
+  }
+
+  const CharT *body = first + 1;
+  const CharT *body_end = last - 1;
+  size_t size = size_t(body_end - body);
+
+  // cut the body in chunks that do not start right after a backslash, so
+  // that no chunk starts inside an escape
+  std::vector<const CharT *> bounds{body};
+
+  for (size_t i = 1; i < chunks; ++i) {
+    const CharT *bound = std::max(bounds.back(), body + size * i / chunks);
+
+    while (bound != body_end && bound[-1] == letters::kBackSolidus<CharT>) {
+      ++bound;
+    }
+
+    bounds.push_back(bound);
+  }
+
+  bounds.push_back(body_end);
+
+  // quote parity of every chunk, then whether every chunk starts in a string
+  detail::TaskGroup<bool> odd{pool};
+
+  for (size_t i = 0; i < chunks; ++i) {
+    odd.Submit([&bounds, i]() {
+      return detail::OddQuotes(bounds[i], bounds[i + 1]);
+    });
+  }
+
+  std::vector<bool> in_string{false};
+
+  for (bool chunk_odd : odd.Get()) {
+    in_string.push_back(in_string.back() != chunk_odd);
+  }
+
+  // depth of every chunk, then the depth at the start of every chunk
+  detail::TaskGroup<ptrdiff_t> depth{pool};
+
+  for (size_t i = 0; i < chunks; ++i) {
+    bool starts_in_string = in_string[i];
+
+    depth.Submit([&bounds, i, starts_in_string]() {
+      return detail::Depth(bounds[i], bounds[i + 1], starts_in_string);
+    });
+  }
+
+  std::vector<ptrdiff_t> depths{0};
+
+  for (ptrdiff_t chunk_depth : depth.Get()) {
+    depths.push_back(depths.back() + chunk_depth);
+  }
+
+  // move every chunk start to the next separator of the value
+  detail::TaskGroup<const CharT *> separators{pool};
+
+  for (size_t i = 1; i < chunks; ++i) {
+    bool starts_in_string = in_string[i];
+    ptrdiff_t start_depth = depths[i];
+
+    separators.Submit(
+        [&bounds, body_end, i, starts_in_string, start_depth]() {
+          return detail::FindSeparator(bounds[i], body_end, starts_in_string,
+                                       start_depth);
+        });
+  }
+
+  std::vector<const CharT *> parts{body};
+
+  for (const CharT *found : separators.Get()) {
+
+    // a separator found by the previous chunk too is only used once
+    if (found != body_end && found >= parts.back()) {
+      parts.push_back(found + 1);
+    }
+  }
+
+  // parse the parts, each separator is left before the next part
+  std::vector<BasicValue<CharT>> values(parts.size());
+  detail::TaskGroup<bool> parsed{pool};
+
+  for (size_t i = 0; i < parts.size(); ++i) {
+    const CharT *part_end = i + 1 < parts.size() ? parts[i + 1] - 1 : body_end;
+
+    parsed.Submit([&, i, part_end]() {
+      return detail::ParseRange(parts[i], part_end, options, open_token,
+                                close_token, values[i]);
+    });
+  }
+
+  bool valid = true;
+
+  for (bool part_valid : parsed.Get()) {
+    valid = part_valid && valid;
+  }
+
+  if (!valid) {
+    return serial();
+  }
+
+  for (size_t i = 1; i < values.size(); ++i) {
+    values[0].Merge(std::move(values[i]));
+  }
+
+  return std::move(values[0]);
+}
+}  // namespace json::parser
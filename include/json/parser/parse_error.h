@@ -0,0 +1,74 @@
+#pragma once
+
+#include <stddef.h>
+#include <algorithm>
+#include <string_view>
+#include "json/utils/error_code.h"
+
+namespace json::parser {
+/**
+ * @brief Why and where a json text was rejected
+ *
+ * Only the offset is recorded while parsing, the line and column are
+ * computed out of the text when they are asked for.
+ */
+struct ParseError {
+  /**
+   * @brief Line and column of a letter, both starting at 1
+   */
+  struct Position {
+    size_t line;
+    size_t column;
+  };
+
+  /**
+   * @brief Find the line and column of the error
+   * @param text the text that was parsed
+   * @returns the position of the letter at `offset`
+   */
+  template <typename CharT>
+  Position Locate(std::basic_string_view<CharT> text) const;
+
+  /**
+   * @brief Describe the error
+   * @returns a short description of `code`
+   */
+  const char *what() const;
+
+  /**
+   * @brief Reason of the error
+   */
+  utils::ErrorCode code = utils::ErrorCode::kNone;
+
+  /**
+   * @brief Offset of the letter that caused the error, or of the letter
+   * after the token that caused the error
+   */
+  size_t offset = 0;
+};
+}  // namespace json::parser
+
+// Implementations
+
+namespace json::parser {
+template <typename CharT>
+ParseError::Position ParseError::Locate(
+    std::basic_string_view<CharT> text) const {
+  std::basic_string_view<CharT> before =
+      text.substr(0, std::min(offset, text.size()));
+  size_t line_start = before.rfind(CharT('\n'));
+
+  Position position;
+  position.line = size_t(std::count(before.begin(), before.end(),
+                                    CharT('\n'))) + 1;
+  position.column = line_start == before.npos
+                        ? before.size() + 1
+                        : before.size() - line_start;
+
+  return position;
+}
+
+inline const char *ParseError::what() const {
+  return utils::Describe(code);
+}
+}  // namespace json::parser
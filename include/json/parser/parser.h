@@ -1,387 +1,355 @@
 #pragma once
 
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
+#include "json/parser/sax.h"
+#include "json/parser/tape.h"
+#include "json/token/compact_token.h"
 #include "json/token/token.h"
 #include "json/token/tokenizer.h"
+#include "json/utils/error_code.h"
 #include "json/value/basic_value.h"
-#include "json/utils/result.h"
 
 namespace json::parser {
+/**
+ * @brief Handler that builds a `BasicValue`, see `Grammar` for the methods of
+ * a handler
+ */
 template <typename CharT>
-class Parser {
+class ValueBuilder {
  public:
-  Parser();
-  void take(const token::Token<CharT> &token);
+  void StartObject();
+  void Key(std::basic_string_view<CharT> key);
+  void EndObject();
+  void StartArray();
+  void EndArray();
+  void String(std::basic_string_view<CharT> string);
+  void Number(const SaxNumber<CharT> &number);
+  void Bool(bool boolean);
+  void Null();
+
+  /**
+   * @brief Get a copy of the value built so far
+   * @returns the value, null if no value was started
+   */
   BasicValue<CharT> root();
 
- private:
-  using _TType = typename token::Token<CharT>::Type;
-  using _VType = typename json::BasicValue<CharT>::Type;
+  /**
+   * @brief Move the value built so far out of the builder, which must be
+   * reset before it builds another value
+   * @returns the value, null if no value was started
+   */
+  BasicValue<CharT> TakeRoot();
+
+  /**
+   * @brief Get ready to build another value, keeping the memory of the stack
+   * and of the key
+   */
+  void Reset();
 
-  struct _Scope {
+ private:
+  struct Scope {
     std::basic_string<CharT> name;
     BasicValue<CharT> value;
 
     template <typename... Arg>
-    _Scope(std::basic_string<CharT> &&name, Arg... args)
-        : name{std::move(name)}, value{args...} {}
-
-    _Scope(_Scope &&other)
-        : name{std::move(other.name)}, value{std::move(other.value)} {}
+    Scope(std::basic_string<CharT> &&name, Arg &&... args)
+        : name{std::move(name)}, value{std::forward<Arg>(args)...} {}
   };
 
-  enum class _State {
-    start,
-    error,
-    finished,
-    objectStart,
-    objectHasKeyString,
-    objectHasKey,
-    objectHasValue,
-    objectReady,
-    arrayStart,
-    arrayHasValue,
-    arrayReady,
-  };
+  /**
+   * @brief Open an object or an array, which is added to its parent once it
+   * is closed
+   */
+  void Open(typename BasicValue<CharT>::Type type);
 
-  enum class _Context {
-    undefined,
-    none,
-    object,
-    array,
-  };
+  /**
+   * @brief Add the object or array on top of the stack to its parent, the
+   * root is kept on the stack
+   */
+  void Close();
 
-  _Context _context();
+  /**
+   * @brief Add a value to the object or array on top of the stack, or make
+   * it the root
+   */
+  void Add(BasicValue<CharT> &&value);
 
-  // State handlers
+  std::vector<Scope> stack_;
+  std::basic_string<CharT> key_;
+};
 
-  void _start(const token::Token<CharT> &token);
-  void _finished(const token::Token<CharT> &token);
-  void _objectStart(const token::Token<CharT> &token);
-  void _objectHasKeyString(const token::Token<CharT> &token);
-  void _objectHasKey(const token::Token<CharT> &token);
-  void _objectHasValue(const token::Token<CharT> &token);
-  void _objectReady(const token::Token<CharT> &token);
-  void _arrayStart(const token::Token<CharT> &token);
-  void _arrayHasValue(const token::Token<CharT> &token);
-  void _arrayReady(const token::Token<CharT> &token);
+/**
+ * @brief Build a value out of the tokens it is given one at a time
+ *
+ * The tokens are checked by a `Grammar` and the value is built by a
+ * `ValueBuilder`, see `SaxParser` to handle the tokens without building a
+ * value.
+ *
+ * The tokens are `Token` by default, see `CompactToken` for tokens that do
+ * not own their letters; the letters are copied before `take` returns.
+ */
+template <typename CharT, typename TokenT = token::Token<CharT>>
+class Parser {
+ public:
+  Parser();
+  void take(const TokenT &token);
+
+  /**
+   * @brief Get a copy of the value built so far
+   * @returns the value, null if no value was started
+   */
+  BasicValue<CharT> root();
+
+  /**
+   * @brief Move the value built so far out of the parser, which must be
+   * reset before it takes more tokens
+   * @returns the value, null if no value was started
+   */
+  BasicValue<CharT> TakeRoot();
+
+  /**
+   * @brief Get ready to build another value, keeping the memory of the stack
+   * and of the key so that one parser can build many values
+   */
+  void Reset();
+
+  /**
+   * @brief Determine if a whole value has been taken
+   * @returns `true` if the value is complete, `false` otherwise
+   */
+  bool done() const;
 
-  _State _state;
-  std::vector<_Scope> _stack;
-  std::basic_string<CharT> _key;
+  /**
+   * @brief Get the error found in the tokens taken, after which the tokens
+   * are ignored
+   * @returns the error, `ErrorCode::kNone` if there is none
+   */
+  utils::ErrorCode error() const;
+
+ private:
+  Grammar<CharT, TokenT> _grammar;
+  ValueBuilder<CharT> _builder;
 };
+
+/**
+ * @brief Build the value that starts at an entry of a tape
+ * @param tape the tape to walk, built successfully so that every object
+ * alternates keys and values and every bracket is closed
+ * @param index position of the first entry of the value, moved past the
+ * value
+ * @returns the value
+ */
+template <typename CharT>
+BasicValue<CharT> FromTape(const Tape<CharT> &tape, size_t &index);
 }  // namespace json::parser
 
 namespace json::parser {
 template <typename CharT>
-Parser<CharT>::Parser() : _state(_State::start) {}
+void ValueBuilder<CharT>::StartObject() {
+  Open(BasicValue<CharT>::Type::kObject);
+}
+
+template <typename CharT>
+void ValueBuilder<CharT>::Key(std::basic_string_view<CharT> key) {
+  key_.assign(key.data(), key.size());
+}
 
 template <typename CharT>
-void Parser<CharT>::take(const token::Token<CharT> &token) {
-  switch (_state) {
-    case _State::start:
-      return _start(token);
-    case _State::finished:
-      return _finished(token);
-    case _State::objectStart:
-      return _objectStart(token);
-    case _State::objectHasKeyString:
-      return _objectHasKeyString(token);
-    case _State::objectHasKey:
-      return _objectHasKey(token);
-    case _State::objectHasValue:
-      return _objectHasValue(token);
-    case _State::objectReady:
-      return _objectReady(token);
-    case _State::arrayStart:
-      return _arrayStart(token);
-    case _State::arrayHasValue:
-      return _arrayHasValue(token);
-    case _State::arrayReady:
-      return _arrayReady(token);
-    case _State::error:
-      return;
-  }
+void ValueBuilder<CharT>::EndObject() {
+  Close();
+}
+
+template <typename CharT>
+void ValueBuilder<CharT>::StartArray() {
+  Open(BasicValue<CharT>::Type::kArray);
+}
+
+template <typename CharT>
+void ValueBuilder<CharT>::EndArray() {
+  Close();
 }
 
 template <typename CharT>
-BasicValue<CharT> Parser<CharT>::root() {
-  return _stack.back().value;
+void ValueBuilder<CharT>::String(std::basic_string_view<CharT> string) {
+  Add(BasicValue<CharT>{string});
 }
 
 template <typename CharT>
-typename Parser<CharT>::_Context Parser<CharT>::_context() {
-  if (_stack.size() <= 1) {
-    return _Context::none;
+void ValueBuilder<CharT>::Number(const SaxNumber<CharT> &number) {
+  if (number.IsRaw()) {
+    return Add({BasicLazyNumber<CharT>{number.letters()}});
   }
 
-  _Scope &parent = _stack[_stack.size() - 2];
+  utils::convert::number::Value value = number.value();
 
-  switch (parent.value.type()) {
-    case BasicValue<CharT>::Type::kObject:
-      return _Context::object;
-    case BasicValue<CharT>::Type::kArray:
-      return _Context::array;
+  switch (value.index()) {
+    case 1:
+      return Add({std::get<1>(value)});
+    case 2:
+      return Add({std::get<2>(value)});
     default:
-      return _Context::none;
+      return Add({std::get<0>(value)});
   }
 }
+
 template <typename CharT>
-void Parser<CharT>::_start(const token::Token<CharT> &token) {
-  switch (token.type) {
-    case _TType::kString:
-      _stack.emplace_back("", token.string());
-      _state = _State::finished;
-      return;
-    case _TType::kNumber:
-      _stack.emplace_back("", token.number());
-      _state = _State::finished;
-      return;
-    case _TType::kBoolean:
-      _stack.emplace_back("", token.boolean());
-      _state = _State::finished;
-      return;
-    case _TType::kNull:
-      _stack.emplace_back("");
-      _state = _State::finished;
-      return;
-    case _TType::kBeginObject:
-      _stack.emplace_back("", _VType::kObject);
-      _state = _State::objectStart;
-      return;
-    case _TType::kBeginArray:
-      _stack.emplace_back("", _VType::kArray);
-      _state = _State::arrayStart;
-      return;
-    default:
-      // TODO: Handle error
-      return;
-  }
+void ValueBuilder<CharT>::Bool(bool boolean) {
+  Add({boolean});
 }
+
 template <typename CharT>
-void Parser<CharT>::_finished(const token::Token<CharT> &token) {
-  // TODO: Handle error
+void ValueBuilder<CharT>::Null() {
+  Add({});
 }
-template <typename CharT>
-void Parser<CharT>::_objectStart(const token::Token<CharT> &token) {
-  switch (token.type) {
-    case _TType::kEndObject: {
-      switch (_context()) {
-        case _Context::object:
-          _state = _State::objectHasValue;
-          break;
-        case _Context::array:
-          _state = _State::arrayHasValue;
-          break;
-        case _Context::none:
-          _state = _State::finished;
-          break;
-        case _Context::undefined:
-          // TODO: Handle error
-          break;
-      }
 
-      return;
-    }
-    case _TType::kString:
-      _key = token.string();
-      _state = _State::objectHasKeyString;
-      return;
-    default:
-      // TODO: Handle error
-      return;
-  }
-}
 template <typename CharT>
-void Parser<CharT>::_objectHasKeyString(const token::Token<CharT> &token) {
-  switch (token.type) {
-    case _TType::kKeyValueSeparator:
-      _state = _State::objectHasKey;
-      break;
-    default:
-      // TODO: Handle error
-      return;
+BasicValue<CharT> ValueBuilder<CharT>::root() {
+  if (stack_.empty()) {
+    return {};
   }
+
+  return stack_.front().value;
 }
+
 template <typename CharT>
-void Parser<CharT>::_objectHasKey(const token::Token<CharT> &token) {
-  switch (token.type) {
-    case _TType::kString:
-      _stack.emplace_back(std::move(_key), token.string());
-      _state = _State::objectHasValue;
-      return;
-    case _TType::kNumber:
-      _stack.emplace_back(std::move(_key), token.number());
-      _state = _State::objectHasValue;
-      return;
-    case _TType::kBoolean:
-      _stack.emplace_back(std::move(_key), token.boolean());
-      _state = _State::objectHasValue;
-      return;
-    case _TType::kNull:
-      _stack.emplace_back(std::move(_key));
-      _state = _State::objectHasValue;
-      return;
-    case _TType::kBeginObject:
-      _stack.emplace_back(std::move(_key), _VType::kObject);
-      _state = _State::objectStart;
-      return;
-    case _TType::kBeginArray:
-      _stack.emplace_back(std::move(_key), _VType::kArray);
-      _state = _State::arrayStart;
-      return;
-    default:
-      // TODO: Handle error
-      return;
+BasicValue<CharT> ValueBuilder<CharT>::TakeRoot() {
+  if (stack_.empty()) {
+    return {};
   }
+
+  return std::move(stack_.front().value);
 }
+
 template <typename CharT>
-void Parser<CharT>::_objectHasValue(const token::Token<CharT> &token) {
-  _Scope top = std::move(_stack.back());
-  _stack.pop_back();
-
-  _Scope &parent = _stack.back();
-  parent.value[top.name] = std::move(top.value);
-
-  switch (token.type) {
-    case _TType::kEndObject: {
-      switch (_context()) {
-        case _Context::object:
-          _state = _State::objectHasValue;
-          break;
-        case _Context::array:
-          _state = _State::arrayHasValue;
-          break;
-        case _Context::none:
-          _state = _State::finished;
-          break;
-        case _Context::undefined:
-          // TODO: Handle error
-          break;
-      }
+void ValueBuilder<CharT>::Reset() {
+  stack_.clear();
+  key_.clear();
+}
 
-      return;
-    }
-    case _TType::kValueSeparator:
-      _state = _State::objectReady;
-      return;
-    default:
-      // TODO: Handle error
-      return;
-  }
+template <typename CharT>
+void ValueBuilder<CharT>::Open(typename BasicValue<CharT>::Type type) {
+  // the key is copied, not moved, so that key_ keeps its memory
+  stack_.emplace_back(std::basic_string<CharT>{key_}, type);
+  key_.clear();
 }
 
 template <typename CharT>
-void Parser<CharT>::_objectReady(const token::Token<CharT> &token) {
-  switch (token.type) {
-    case _TType::kString:
-      _key = token.string();
-      _state = _State::objectHasKeyString;
-      return;
-    default:
-      // TODO: Handle error
-      return;
+void ValueBuilder<CharT>::Close() {
+  if (stack_.size() == 1) {
+    return;
+  }
+
+  Scope top = std::move(stack_.back());
+  stack_.pop_back();
+
+  BasicValue<CharT> &parent = stack_.back().value;
+
+  if (parent.IsArray()) {
+    parent.Append(std::move(top.value));
+  } else {
+    parent.Set(std::move(top.name), std::move(top.value));
   }
 }
+
 template <typename CharT>
-void Parser<CharT>::_arrayStart(const token::Token<CharT> &token) {
-  switch (token.type) {
-    case _TType::kString:
-      _stack.emplace_back(std::move(_key), token.string());
-      _state = _State::arrayHasValue;
-      return;
-    case _TType::kNumber:
-      _stack.emplace_back(std::move(_key), token.number());
-      _state = _State::arrayHasValue;
-      return;
-    case _TType::kBoolean:
-      _stack.emplace_back(std::move(_key), token.boolean());
-      _state = _State::arrayHasValue;
-      return;
-    case _TType::kNull:
-      _stack.emplace_back(std::move(_key));
-      _state = _State::arrayHasValue;
-      return;
-    case _TType::kBeginObject:
-      _stack.emplace_back(std::move(_key), _VType::kObject);
-      _state = _State::objectStart;
-      return;
-    case _TType::kBeginArray:
-      _stack.emplace_back(std::move(_key), _VType::kArray);
-      _state = _State::arrayStart;
-      return;
-    default:
-      // TODO: Handle error
-      return;
+void ValueBuilder<CharT>::Add(BasicValue<CharT> &&value) {
+  if (stack_.empty()) {
+    stack_.emplace_back(std::basic_string<CharT>{}, std::move(value));
+    return;
+  }
+
+  BasicValue<CharT> &parent = stack_.back().value;
+
+  if (parent.IsArray()) {
+    parent.Append(std::move(value));
+  } else {
+    parent.Set(typename BasicValue<CharT>::Key{key_}, std::move(value));
+    key_.clear();
   }
 }
+
+template <typename CharT, typename TokenT>
+Parser<CharT, TokenT>::Parser() {}
+
+template <typename CharT, typename TokenT>
+void Parser<CharT, TokenT>::take(const TokenT &token) {
+  _grammar.take(token, _builder);
+}
+
+template <typename CharT, typename TokenT>
+BasicValue<CharT> Parser<CharT, TokenT>::root() {
+  return _builder.root();
+}
+
+template <typename CharT, typename TokenT>
+BasicValue<CharT> Parser<CharT, TokenT>::TakeRoot() {
+  return _builder.TakeRoot();
+}
+
+template <typename CharT, typename TokenT>
+void Parser<CharT, TokenT>::Reset() {
+  _grammar.Reset();
+  _builder.Reset();
+}
+
+template <typename CharT, typename TokenT>
+bool Parser<CharT, TokenT>::done() const {
+  return _grammar.done();
+}
+
+template <typename CharT, typename TokenT>
+utils::ErrorCode Parser<CharT, TokenT>::error() const {
+  return _grammar.error();
+}
+
 template <typename CharT>
-void Parser<CharT>::_arrayHasValue(const token::Token<CharT> &token) {
-  _Scope top = std::move(_stack.back());
-  _stack.pop_back();
-
-  _Scope &parent = _stack.back();
-  parent.value.Append(std::move(top.value));
-
-  switch (token.type) {
-    case _TType::kEndArray: {
-      switch (_context()) {
-        case _Context::object:
-          _state = _State::objectHasValue;
-          break;
-        case _Context::array:
-          _state = _State::arrayHasValue;
-          break;
-        case _Context::none:
-          _state = _State::finished;
-          break;
-        case _Context::undefined:
-          // TODO: Handle error
-          break;
+BasicValue<CharT> FromTape(const Tape<CharT> &tape, size_t &index) {
+  using TapeType = typename Tape<CharT>::Type;
+  using VType = typename BasicValue<CharT>::Type;
+
+  size_t current = index++;
+
+  switch (tape[current].type) {
+    case TapeType::kBeginObject: {
+      BasicValue<CharT> object{VType::kObject};
+
+      while (tape[index].type != TapeType::kEndObject) {
+        std::basic_string<CharT> key{tape.string(index++)};
+        object.Set(std::move(key), FromTape(tape, index));
       }
 
-      return;
+      ++index;
+      return object;
     }
-    case _TType::kValueSeparator:
-      _state = _State::arrayReady;
-      return;
-    default:
-      // TODO: Handle error
-      return;
-  }
-}
-template <typename CharT>
-void Parser<CharT>::_arrayReady(const token::Token<CharT> &token) {
-  switch (token.type) {
-    case _TType::kString:
-      _stack.emplace_back(std::move(_key), token.string());
-      _state = _State::arrayHasValue;
-      return;
-    case _TType::kNumber:
-      _stack.emplace_back(std::move(_key), token.number());
-      _state = _State::arrayHasValue;
-      return;
-    case _TType::kBoolean:
-      _stack.emplace_back(std::move(_key), token.boolean());
-      _state = _State::arrayHasValue;
-      return;
-    case _TType::kNull:
-      _stack.emplace_back(std::move(_key));
-      _state = _State::arrayHasValue;
-      return;
-    case _TType::kBeginObject:
-      _stack.emplace_back(std::move(_key), _VType::kObject);
-      _state = _State::objectStart;
-      return;
-    case _TType::kBeginArray:
-      _stack.emplace_back(std::move(_key), _VType::kArray);
-      _state = _State::arrayStart;
-      return;
+    case TapeType::kBeginArray: {
+      BasicValue<CharT> array{VType::kArray};
+
+      while (tape[index].type != TapeType::kEndArray) {
+        array.Append(FromTape(tape, index));
+      }
+
+      ++index;
+      return array;
+    }
+    case TapeType::kString:
+      return BasicValue<CharT>{tape.string(current)};
+    case TapeType::kInt64:
+      return {tape.int64(current)};
+    case TapeType::kUint64:
+      return {tape.uint64(current)};
+    case TapeType::kRawNumber:
+      return {BasicLazyNumber<CharT>{tape.string(current)}};
+    case TapeType::kTrue:
+      return {true};
+    case TapeType::kFalse:
+      return {false};
+    case TapeType::kNull:
+      return {};
     default:
-      // TODO: Handle error
-      return;
+      return {tape.number(current)};
   }
 }
-
 }  // namespace json::parser
@@ -0,0 +1,383 @@
+#pragma once
+
+#include <stdint.h>
+#include <string_view>
+#include <vector>
+#include "json/token/token.h"
+#include "json/utils/convert.h"
+#include "json/utils/error_code.h"
+
+namespace json::parser {
+/**
+ * @brief Number handed to a handler, either converted by the tokenizer or
+ * kept as letters when lazy numbers are enabled
+ */
+template <typename CharT>
+class SaxNumber {
+ public:
+  /**
+   * @brief Create a number converted by the tokenizer
+   */
+  explicit SaxNumber(utils::convert::number::Value value);
+
+  /**
+   * @brief Create a number out of its letters, which are converted when the
+   * value is asked for
+   */
+  explicit SaxNumber(std::basic_string_view<CharT> letters);
+
+  /**
+   * @brief Determine if the number was kept as letters
+   */
+  bool IsRaw() const;
+
+  /**
+   * @brief Get the letters of a raw number, valid until the handler returns
+   */
+  std::basic_string_view<CharT> letters() const;
+
+  /**
+   * @brief Get the value of the number, converting the letters of a raw
+   * number
+   */
+  utils::convert::number::Value value() const;
+
+ private:
+  std::basic_string_view<CharT> letters_;
+  utils::convert::number::Value value_;
+  bool raw_;
+};
+
+/**
+ * @brief Check that tokens make a json value and call the methods of a
+ * handler for every part of the value
+ *
+ * The handler is given to every call of `take`, so that the grammar does not
+ * hold a reference to it. A handler has the methods:
+ *
+ * - `StartObject()`, `Key(std::basic_string_view<CharT>)`, `EndObject()`
+ * - `StartArray()`, `EndArray()`
+ * - `String(std::basic_string_view<CharT>)`, `Number(const SaxNumber<CharT>
+ *   &)`, `Bool(bool)`, `Null()`
+ *
+ * The letters given to `Key` and `String` are only valid until the method
+ * returns.
+ */
+template <typename CharT, typename TokenT>
+class Grammar {
+ public:
+  /**
+   * @brief Check a token and call the handler
+   * @param token the token, comments and uninitialized tokens are ignored
+   * @param handler the handler to call
+   */
+  template <typename HandlerT>
+  void take(const TokenT &token, HandlerT &handler);
+
+  /**
+   * @brief Determine if a whole value has been taken
+   */
+  bool done() const;
+
+  /**
+   * @brief Get the error found in the tokens taken, after which the tokens
+   * are ignored
+   * @returns the error, `ErrorCode::kNone` if there is none
+   */
+  utils::ErrorCode error() const;
+
+  /**
+   * @brief Get ready to check another value, keeping the memory of the stack
+   */
+  void Reset();
+
+ private:
+  using TType = typename TokenT::Type;
+
+  enum class State : uint8_t {
+    kStart,
+    kFinished,
+    kError,
+    kObjectStart,
+    kObjectKey,
+    kObjectColon,
+    kObjectValue,
+    kObjectComma,
+    kArrayStart,
+    kArrayValue,
+    kArrayComma,
+  };
+
+  enum class Scope : uint8_t {
+    kObject,
+    kArray,
+  };
+
+  template <typename HandlerT>
+  void TakeValue(const TokenT &token, HandlerT &handler);
+
+  template <typename HandlerT>
+  void End(Scope scope, HandlerT &handler);
+
+  /**
+   * @brief Move to the state after a value of the current scope
+   */
+  void AfterValue();
+
+  void Fail(utils::ErrorCode error);
+
+  State state_ = State::kStart;
+  std::vector<Scope> scopes_;
+  utils::ErrorCode error_ = utils::ErrorCode::kNone;
+};
+
+/**
+ * @brief Call the methods of a handler for the tokens it is given one at a
+ * time, see `Grammar` for the methods of a handler
+ *
+ * The handler is a template parameter so that its methods can be inlined,
+ * `ValueBuilder` is the handler that builds a `BasicValue`.
+ */
+template <typename CharT, typename HandlerT,
+          typename TokenT = token::Token<CharT>>
+class SaxParser {
+ public:
+  /**
+   * @brief Create a parser for a handler
+   * @param handler the handler to call, must outlive the parser
+   */
+  SaxParser(HandlerT &handler);
+
+  void take(const TokenT &token);
+
+  /**
+   * @brief Determine if a whole value has been taken
+   */
+  bool done() const;
+
+  /**
+   * @brief Get the error found in the tokens taken
+   * @returns the error, `ErrorCode::kNone` if there is none
+   */
+  utils::ErrorCode error() const;
+
+  /**
+   * @brief Get ready to parse another value
+   */
+  void Reset();
+
+ private:
+  HandlerT &handler_;
+  Grammar<CharT, TokenT> grammar_;
+};
+}  // namespace json::parser
+
+// Implementations
+
+namespace json::parser {
+template <typename CharT>
+SaxNumber<CharT>::SaxNumber(utils::convert::number::Value value)
+    : value_(value), raw_(false) {}
+
+template <typename CharT>
+SaxNumber<CharT>::SaxNumber(std::basic_string_view<CharT> letters)
+    : letters_(letters), raw_(true) {}
+
+template <typename CharT>
+bool SaxNumber<CharT>::IsRaw() const {
+  return raw_;
+}
+
+template <typename CharT>
+std::basic_string_view<CharT> SaxNumber<CharT>::letters() const {
+  return letters_;
+}
+
+template <typename CharT>
+utils::convert::number::Value SaxNumber<CharT>::value() const {
+  if (raw_) {
+    return utils::convert::number::Parse(letters_.data(),
+                                         letters_.data() + letters_.size());
+  }
+
+  return value_;
+}
+
+template <typename CharT, typename TokenT>
+template <typename HandlerT>
+void Grammar<CharT, TokenT>::take(const TokenT &token, HandlerT &handler) {
+  // comments can appear anywhere and are not part of the value, tokenizers
+  // end on an uninitialized token when only whitespaces are left
+  if (token.type == TType::kComment || token.type == TType::kUninitialized) {
+    return;
+  }
+
+  switch (state_) {
+    case State::kStart:
+    case State::kObjectColon:
+    case State::kArrayComma:
+      return TakeValue(token, handler);
+    case State::kArrayStart:
+      if (token.type == TType::kEndArray) {
+        return End(Scope::kArray, handler);
+      }
+
+      return TakeValue(token, handler);
+    case State::kObjectStart:
+      if (token.type == TType::kEndObject) {
+        return End(Scope::kObject, handler);
+      }
+
+      [[fallthrough]];
+    case State::kObjectComma:
+      if (token.type != TType::kString) {
+        return Fail(utils::ErrorCode::kUnexpectedToken);
+      }
+
+      handler.Key(token.string());
+      state_ = State::kObjectKey;
+      return;
+    case State::kObjectKey:
+      if (token.type != TType::kKeyValueSeparator) {
+        return Fail(utils::ErrorCode::kUnexpectedToken);
+      }
+
+      state_ = State::kObjectColon;
+      return;
+    case State::kObjectValue:
+      switch (token.type) {
+        case TType::kValueSeparator:
+          state_ = State::kObjectComma;
+          return;
+        case TType::kEndObject:
+          return End(Scope::kObject, handler);
+        default:
+          return Fail(utils::ErrorCode::kUnexpectedToken);
+      }
+    case State::kArrayValue:
+      switch (token.type) {
+        case TType::kValueSeparator:
+          state_ = State::kArrayComma;
+          return;
+        case TType::kEndArray:
+          return End(Scope::kArray, handler);
+        default:
+          return Fail(utils::ErrorCode::kUnexpectedToken);
+      }
+    case State::kFinished:
+      // only one value can be parsed
+      return Fail(utils::ErrorCode::kUnexpectedToken);
+    case State::kError:
+      return;
+  }
+}
+
+template <typename CharT, typename TokenT>
+bool Grammar<CharT, TokenT>::done() const {
+  return state_ == State::kFinished;
+}
+
+template <typename CharT, typename TokenT>
+utils::ErrorCode Grammar<CharT, TokenT>::error() const {
+  return error_;
+}
+
+template <typename CharT, typename TokenT>
+void Grammar<CharT, TokenT>::Reset() {
+  state_ = State::kStart;
+  scopes_.clear();
+  error_ = utils::ErrorCode::kNone;
+}
+
+template <typename CharT, typename TokenT>
+template <typename HandlerT>
+void Grammar<CharT, TokenT>::TakeValue(const TokenT &token,
+                                       HandlerT &handler) {
+  switch (token.type) {
+    case TType::kString:
+      handler.String(token.string());
+      return AfterValue();
+    case TType::kNumber:
+      if (token.IsRawNumber()) {
+        handler.Number(SaxNumber<CharT>{token.string()});
+      } else {
+        handler.Number(SaxNumber<CharT>{token.NumberValue()});
+      }
+
+      return AfterValue();
+    case TType::kBoolean:
+      handler.Bool(token.boolean());
+      return AfterValue();
+    case TType::kNull:
+      handler.Null();
+      return AfterValue();
+    case TType::kBeginObject:
+      scopes_.push_back(Scope::kObject);
+      state_ = State::kObjectStart;
+      handler.StartObject();
+      return;
+    case TType::kBeginArray:
+      scopes_.push_back(Scope::kArray);
+      state_ = State::kArrayStart;
+      handler.StartArray();
+      return;
+    default:
+      return Fail(utils::ErrorCode::kUnexpectedToken);
+  }
+}
+
+template <typename CharT, typename TokenT>
+template <typename HandlerT>
+void Grammar<CharT, TokenT>::End(Scope scope, HandlerT &handler) {
+  scopes_.pop_back();
+
+  if (scope == Scope::kObject) {
+    handler.EndObject();
+  } else {
+    handler.EndArray();
+  }
+
+  AfterValue();
+}
+
+template <typename CharT, typename TokenT>
+void Grammar<CharT, TokenT>::AfterValue() {
+  if (scopes_.empty()) {
+    state_ = State::kFinished;
+  } else if (scopes_.back() == Scope::kObject) {
+    state_ = State::kObjectValue;
+  } else {
+    state_ = State::kArrayValue;
+  }
+}
+
+template <typename CharT, typename TokenT>
+void Grammar<CharT, TokenT>::Fail(utils::ErrorCode error) {
+  state_ = State::kError;
+  error_ = error;
+}
+
+template <typename CharT, typename HandlerT, typename TokenT>
+SaxParser<CharT, HandlerT, TokenT>::SaxParser(HandlerT &handler)
+    : handler_(handler) {}
+
+template <typename CharT, typename HandlerT, typename TokenT>
+void SaxParser<CharT, HandlerT, TokenT>::take(const TokenT &token) {
+  grammar_.take(token, handler_);
+}
+
+template <typename CharT, typename HandlerT, typename TokenT>
+bool SaxParser<CharT, HandlerT, TokenT>::done() const {
+  return grammar_.done();
+}
+
+template <typename CharT, typename HandlerT, typename TokenT>
+utils::ErrorCode SaxParser<CharT, HandlerT, TokenT>::error() const {
+  return grammar_.error();
+}
+
+template <typename CharT, typename HandlerT, typename TokenT>
+void SaxParser<CharT, HandlerT, TokenT>::Reset() {
+  grammar_.Reset();
+}
+}  // namespace json::parser
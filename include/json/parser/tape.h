@@ -0,0 +1,379 @@
+#pragma once
+
+#include <stdint.h>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "json/parser/sax.h"
+#include "json/token/compact_token.h"
+#include "json/token/options.h"
+#include "json/token/tokenizer.h"
+#include "json/utils/error_code.h"
+
+namespace json::parser {
+/**
+ * @brief Tokens of a whole json text, laid out as a contiguous array of
+ * fixed size entries
+ *
+ * The tokens are checked by the same `Grammar` as `Parser`, so a tape that
+ * was built successfully holds exactly one json value. Separators and
+ * comments are not recorded, the keys of objects are string entries followed
+ * by the entry of their value. Strings and raw numbers are referenced by
+ * offset and length, into the text when they have no escapes and into the
+ * string arena of the tape otherwise. Numbers are stored in the entries, and
+ * every bracket entry holds the index of its matching bracket so that whole
+ * containers can be skipped at once.
+ *
+ * Lengths and the indices of open brackets are 32 bit to keep entries at 16
+ * bytes, `Build` rejects texts of 4GiB letters or more. Strings and raw
+ * numbers referencing the text require the text to outlive the tape.
+ */
+template <typename CharT>
+class Tape {
+ public:
+  using StringViewData = std::basic_string_view<CharT>;
+
+  enum class Type : uint8_t {
+    kBeginObject,
+    kEndObject,
+    kBeginArray,
+    kEndArray,
+    kString,
+    kDouble,
+    kInt64,
+    kUint64,
+    kRawNumber,
+    kTrue,
+    kFalse,
+    kNull,
+  };
+
+  /**
+   * @brief An entry of the tape
+   */
+  struct Entry {
+    Type type;
+
+    /**
+     * @brief `true` if the letters are in the string arena of the tape
+     */
+    bool arena;
+
+    /**
+     * @brief Number of letters of strings and raw numbers
+     */
+    uint32_t length;
+
+    /**
+     * @brief Offset of the letters of strings and raw numbers, index of the
+     * matching bracket of brackets, bits of numbers
+     */
+    uint64_t payload;
+  };
+
+  static_assert(sizeof(Entry) == 16, "tape entries must stay 16 bytes");
+
+  /**
+   * @brief Tokenize a text, replacing the previous content of the tape while
+   * keeping its capacity
+   * @param begin pointer to the first letter of the text
+   * @param end pointer past the last letter of the text
+   * @param options opt-in behaviours of the tokenizer
+   * @returns `true` on success, `false` if the text is not valid or has
+   * 4GiB letters or more, see `error()`, in which case the tape is left empty
+   */
+  bool Build(const CharT *begin, const CharT *end,
+             const token::Options &options = {});
+
+  /**
+   * @brief Get the error that stopped the last build
+   * @returns the error, `ErrorCode::kNone` if there is none
+   */
+  utils::ErrorCode error() const;
+
+  /**
+   * @brief Number of entries in the tape
+   */
+  size_t size() const;
+
+  /**
+   * @brief Get an entry
+   * @param index position of the entry in the tape
+   */
+  const Entry &operator[](size_t index) const;
+
+  /**
+   * @brief Get the index past the value that starts at an entry, the
+   * brackets of containers are not walked through
+   * @param index position of the first entry of the value
+   * @returns the position of the entry after the value
+   */
+  size_t Skip(size_t index) const;
+
+  /**
+   * @brief Get the letters of a string or raw number entry
+   */
+  StringViewData string(size_t index) const;
+
+  /**
+   * @brief Get the number of a number entry as a double, converting integers
+   */
+  double number(size_t index) const;
+
+  /**
+   * @brief Get the number of a `kInt64` entry
+   */
+  int64_t int64(size_t index) const;
+
+  /**
+   * @brief Get the number of a `kUint64` entry
+   */
+  uint64_t uint64(size_t index) const;
+
+ private:
+  /**
+   * @brief Handler of the grammar, the entries are pushed from the tokens
+   */
+  struct Ignore {
+    void StartObject() {}
+    void Key(StringViewData) {}
+    void EndObject() {}
+    void StartArray() {}
+    void EndArray() {}
+    void String(StringViewData) {}
+    void Number(const SaxNumber<CharT> &) {}
+    void Bool(bool) {}
+    void Null() {}
+  };
+
+  void Push(Type type, uint64_t payload = 0);
+  void PushString(Type type, const token::CompactToken<CharT> &token);
+  void PushNumber(const token::CompactToken<CharT> &token);
+  void Open(Type type);
+  void Close(Type type);
+
+  /**
+   * @brief Record an error and empty the tape
+   * @returns `false`
+   */
+  bool Fail(utils::ErrorCode error);
+
+  std::vector<Entry> entries_;
+  std::basic_string<CharT> arena_;
+  std::vector<uint32_t> open_;
+  const CharT *text_ = nullptr;
+  Grammar<CharT, token::CompactToken<CharT>> grammar_;
+  utils::ErrorCode error_ = utils::ErrorCode::kNone;
+};
+}  // namespace json::parser
+
+// Implementations
+
+namespace json::parser {
+template <typename CharT>
+bool Tape<CharT>::Build(const CharT *begin, const CharT *end,
+                        const token::Options &options) {
+  using TType = typename token::CompactToken<CharT>::Type;
+
+  entries_.clear();
+  arena_.clear();
+  open_.clear();
+  text_ = begin;
+  grammar_.Reset();
+  error_ = utils::ErrorCode::kNone;
+
+  // lengths and bracket indices would wrap around
+  if (size_t(end - begin) > UINT32_MAX) {
+    return Fail(utils::ErrorCode::kTooLarge);
+  }
+
+  token::CompactTokenizer<CharT> tokenizer{{begin, end}, options};
+  Ignore ignore;
+
+  while (!tokenizer.Done()) {
+    tokenizer.Extract();
+    const token::CompactToken<CharT> &token = tokenizer.token();
+
+    // the token is only recorded once the grammar allows it
+    grammar_.take(token, ignore);
+
+    if (grammar_.error() != utils::ErrorCode::kNone) {
+      return Fail(grammar_.error());
+    }
+
+    switch (token.type) {
+      case TType::kBeginObject:
+        Open(Type::kBeginObject);
+        break;
+      case TType::kBeginArray:
+        Open(Type::kBeginArray);
+        break;
+      case TType::kEndObject:
+        Close(Type::kEndObject);
+        break;
+      case TType::kEndArray:
+        Close(Type::kEndArray);
+        break;
+      case TType::kString:
+        PushString(Type::kString, token);
+        break;
+      case TType::kNumber:
+        PushNumber(token);
+        break;
+      case TType::kBoolean:
+        Push(token.boolean() ? Type::kTrue : Type::kFalse);
+        break;
+      case TType::kNull:
+        Push(Type::kNull);
+        break;
+      default:
+        // separators and comments are implied by the layout of the tape
+        break;
+    }
+  }
+
+  if (tokenizer.error() != utils::ErrorCode::kNone) {
+    return Fail(tokenizer.error());
+  }
+
+  // like the other entry points, a text without a value is not valid
+  if (!grammar_.done()) {
+    return Fail(utils::ErrorCode::kUnexpectedEnd);
+  }
+
+  return true;
+}
+
+template <typename CharT>
+utils::ErrorCode Tape<CharT>::error() const {
+  return error_;
+}
+
+template <typename CharT>
+size_t Tape<CharT>::size() const {
+  return entries_.size();
+}
+
+template <typename CharT>
+const typename Tape<CharT>::Entry &Tape<CharT>::operator[](
+    size_t index) const {
+  return entries_[index];
+}
+
+template <typename CharT>
+size_t Tape<CharT>::Skip(size_t index) const {
+  const Entry &entry = entries_[index];
+
+  if (entry.type == Type::kBeginObject || entry.type == Type::kBeginArray) {
+    return size_t(entry.payload) + 1;
+  }
+
+  return index + 1;
+}
+
+template <typename CharT>
+typename Tape<CharT>::StringViewData Tape<CharT>::string(size_t index) const {
+  const Entry &entry = entries_[index];
+  const CharT *letters = entry.arena ? arena_.data() : text_;
+
+  return {letters + entry.payload, entry.length};
+}
+
+template <typename CharT>
+double Tape<CharT>::number(size_t index) const {
+  const Entry &entry = entries_[index];
+
+  switch (entry.type) {
+    case Type::kInt64:
+      return double(int64(index));
+    case Type::kUint64:
+      return double(entry.payload);
+    default: {
+      double number;
+      std::memcpy(&number, &entry.payload, sizeof(number));
+      return number;
+    }
+  }
+}
+
+template <typename CharT>
+int64_t Tape<CharT>::int64(size_t index) const {
+  return int64_t(entries_[index].payload);
+}
+
+template <typename CharT>
+uint64_t Tape<CharT>::uint64(size_t index) const {
+  return entries_[index].payload;
+}
+
+template <typename CharT>
+void Tape<CharT>::Push(Type type, uint64_t payload) {
+  entries_.push_back({type, false, 0, payload});
+}
+
+template <typename CharT>
+void Tape<CharT>::PushString(Type type,
+                             const token::CompactToken<CharT> &token) {
+  StringViewData letters = token.string();
+
+  if (token.IsStringView()) {
+    entries_.push_back({type, false, uint32_t(letters.size()),
+                        uint64_t(letters.data() - text_)});
+    return;
+  }
+
+  // strings with escapes were decoded by the tokenizer
+  entries_.push_back(
+      {type, true, uint32_t(letters.size()), uint64_t(arena_.size())});
+  arena_.append(letters);
+}
+
+template <typename CharT>
+void Tape<CharT>::PushNumber(const token::CompactToken<CharT> &token) {
+  using Data = typename token::CompactToken<CharT>::Data;
+
+  switch (token.data) {
+    case Data::kView:
+      PushString(Type::kRawNumber, token);
+      break;
+    case Data::kInt64:
+      Push(Type::kInt64, uint64_t(token.int64_data));
+      break;
+    case Data::kUint64:
+      Push(Type::kUint64, token.uint64_data);
+      break;
+    default: {
+      uint64_t bits;
+      std::memcpy(&bits, &token.number_data, sizeof(bits));
+      Push(Type::kDouble, bits);
+      break;
+    }
+  }
+}
+
+template <typename CharT>
+void Tape<CharT>::Open(Type type) {
+  open_.push_back(uint32_t(entries_.size()));
+  Push(type);
+}
+
+template <typename CharT>
+void Tape<CharT>::Close(Type type) {
+  // the grammar makes sure that the bracket matches
+  uint32_t begin = open_.back();
+  open_.pop_back();
+
+  entries_[begin].payload = entries_.size();
+  Push(type, begin);
+}
+
+template <typename CharT>
+bool Tape<CharT>::Fail(utils::ErrorCode error) {
+  entries_.clear();
+  error_ = error;
+
+  return false;
+}
+}  // namespace json::parser
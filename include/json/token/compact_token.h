@@ -0,0 +1,332 @@
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <variant>
+#include "json/token/token.h"
+#include "json/utils/convert.h"
+
+namespace json::token {
+/**
+ * @brief Token that fits in 16 bytes and is trivially copyable
+ *
+ * Letters are never owned: strings, comments and raw numbers reference
+ * either the input or a buffer of the tokenizer that is reused from one
+ * token to the next. The letters are only valid until the tokenizer extracts
+ * the next token, consumers that keep them must copy them. Numbers and
+ * booleans are stored in the token. The length of the letters is 32 bit, so
+ * strings must be shorter than 4GiB letters.
+ */
+template <typename CharT>
+struct CompactToken {
+  using Type = typename Token<CharT>::Type;
+  using StringData = std::basic_string<CharT>;
+  using StringViewData = std::basic_string_view<CharT>;
+
+  /**
+   * @brief Largest number of letters of a string, comment or raw number,
+   * tokenizers fail with `ErrorCode::kTooLarge` on longer ones
+   */
+  static constexpr size_t kMaxLength = UINT32_MAX;
+
+  /**
+   * @brief Kind of data held by the token
+   */
+  enum class Data : uint8_t {
+    kNone,
+    kView,
+    kBuffer,
+    kDouble,
+    kInt64,
+    kUint64,
+    kBoolean,
+  };
+
+  /**
+   * Get the letters if the type is string or comment
+   * @returns a view of the letters
+   */
+  StringViewData string() const;
+
+  /**
+   * See if the letters reference the input instead of a buffer of the
+   * tokenizer
+   * @returns `true` if the letters are in the input, `false` otherwise
+   */
+  bool IsStringView() const;
+
+  /**
+   * Get the number as a double, converting integers
+   * @returns the number
+   */
+  double number() const;
+
+  /**
+   * See if the number is an integer that fits in 64 bits
+   * @returns `true` if the number is an integer, `false` otherwise
+   */
+  bool IsInteger() const;
+
+  /**
+   * See if the number is the letters of the number, referencing the input,
+   * instead of its value
+   * @returns `true` if the number is raw, `false` otherwise
+   */
+  bool IsRawNumber() const;
+
+  /**
+   * Get the value of the number, converting the letters of a raw number
+   * @returns the value of the number
+   */
+  utils::convert::number::Value NumberValue() const;
+
+  /**
+   * Get the number as a signed integer, converting other numbers
+   * @returns the number
+   */
+  int64_t int64() const;
+
+  /**
+   * Get the number as an unsigned integer, converting other numbers
+   * @returns the number
+   */
+  uint64_t uint64() const;
+
+  /**
+   * Get the boolean
+   * @returns the boolean
+   */
+  bool boolean() const;
+
+  /**
+   * Become a string token that references the input
+   * @param view the letters of the string
+   */
+  void FormStringView(StringViewData view);
+
+  /**
+   * Become a string token that references the letters of a buffer, which
+   * must not change while the token is used
+   * @param buffer the buffer holding the letters
+   */
+  void FormBufferString(StringData &buffer);
+
+  /**
+   * Become a comment token that references the input
+   * @param view the letters of the comment
+   */
+  void FormCommentView(StringViewData view);
+
+  /**
+   * Become a comment token that references the letters of a buffer, which
+   * must not change while the token is used
+   * @param buffer the buffer holding the letters
+   */
+  void FormBufferComment(StringData &buffer);
+
+  /**
+   * Become a number token holding a converted value
+   * @param value the value to give to the token
+   */
+  void FormValue(const utils::convert::number::Value &value);
+
+  /**
+   * Become a number token that keeps the letters of the number
+   * @param text the letters of the number
+   */
+  void FormRawNumber(StringViewData text);
+
+  /**
+   * Become a boolean token
+   * @param boolean the value to give to the token
+   */
+  void FormBoolean(bool boolean);
+
+  /**
+   * Type of the token
+   */
+  Type type = Type::kUninitialized;
+
+  /**
+   * Kind of data held by the token
+   */
+  Data data = Data::kNone;
+
+  /**
+   * Number of letters of strings, comments and raw numbers
+   */
+  uint32_t length = 0;
+
+  union {
+    const CharT *letters;
+    double number_data;
+    int64_t int64_data;
+    uint64_t uint64_data;
+    bool boolean_data;
+  };
+};
+
+static_assert(std::is_trivially_copyable_v<CompactToken<char>>,
+              "compact tokens must be trivially copyable");
+static_assert(sizeof(CompactToken<char>) <= 16,
+              "compact tokens must fit in 16 bytes");
+}  // namespace json::token
+
+// Implementations
+
+namespace json::token {
+template <typename CharT>
+typename CompactToken<CharT>::StringViewData CompactToken<CharT>::string()
+    const {
+  return {letters, length};
+}
+
+template <typename CharT>
+bool CompactToken<CharT>::IsStringView() const {
+  return data == Data::kView;
+}
+
+template <typename CharT>
+double CompactToken<CharT>::number() const {
+  switch (data) {
+    case Data::kInt64:
+      return double(int64_data);
+    case Data::kUint64:
+      return double(uint64_data);
+    case Data::kView:
+      return std::visit([](auto value) { return double(value); },
+                        NumberValue());
+    default:
+      return number_data;
+  }
+}
+
+template <typename CharT>
+bool CompactToken<CharT>::IsInteger() const {
+  if (data == Data::kView) {
+    return NumberValue().index() != 0;
+  }
+
+  return data == Data::kInt64 || data == Data::kUint64;
+}
+
+template <typename CharT>
+bool CompactToken<CharT>::IsRawNumber() const {
+  return type == Type::kNumber && data == Data::kView;
+}
+
+template <typename CharT>
+utils::convert::number::Value CompactToken<CharT>::NumberValue() const {
+  using namespace utils::convert;
+
+  switch (data) {
+    case Data::kView:
+      return number::Parse(letters, letters + length);
+    case Data::kInt64:
+      return int64_data;
+    case Data::kUint64:
+      return uint64_data;
+    default:
+      return number_data;
+  }
+}
+
+template <typename CharT>
+int64_t CompactToken<CharT>::int64() const {
+  switch (data) {
+    case Data::kInt64:
+      return int64_data;
+    case Data::kUint64:
+      return int64_t(uint64_data);
+    case Data::kView:
+      return std::visit([](auto value) { return int64_t(value); },
+                        NumberValue());
+    default:
+      return int64_t(number_data);
+  }
+}
+
+template <typename CharT>
+uint64_t CompactToken<CharT>::uint64() const {
+  switch (data) {
+    case Data::kInt64:
+      return uint64_t(int64_data);
+    case Data::kUint64:
+      return uint64_data;
+    case Data::kView:
+      return std::visit([](auto value) { return uint64_t(value); },
+                        NumberValue());
+    default:
+      return uint64_t(number_data);
+  }
+}
+
+template <typename CharT>
+bool CompactToken<CharT>::boolean() const {
+  return boolean_data;
+}
+
+template <typename CharT>
+void CompactToken<CharT>::FormStringView(StringViewData view) {
+  type = Type::kString;
+  data = Data::kView;
+  length = uint32_t(view.size());
+  letters = view.data();
+}
+
+template <typename CharT>
+void CompactToken<CharT>::FormBufferString(StringData &buffer) {
+  type = Type::kString;
+  data = Data::kBuffer;
+  length = uint32_t(buffer.size());
+  letters = buffer.data();
+}
+
+template <typename CharT>
+void CompactToken<CharT>::FormCommentView(StringViewData view) {
+  FormStringView(view);
+  type = Type::kComment;
+}
+
+template <typename CharT>
+void CompactToken<CharT>::FormBufferComment(StringData &buffer) {
+  FormBufferString(buffer);
+  type = Type::kComment;
+}
+
+template <typename CharT>
+void CompactToken<CharT>::FormValue(
+    const utils::convert::number::Value &value) {
+  type = Type::kNumber;
+
+  switch (value.index()) {
+    case 1:
+      data = Data::kInt64;
+      int64_data = std::get<1>(value);
+      break;
+    case 2:
+      data = Data::kUint64;
+      uint64_data = std::get<2>(value);
+      break;
+    default:
+      data = Data::kDouble;
+      number_data = std::get<0>(value);
+      break;
+  }
+}
+
+template <typename CharT>
+void CompactToken<CharT>::FormRawNumber(StringViewData text) {
+  FormStringView(text);
+  type = Type::kNumber;
+}
+
+template <typename CharT>
+void CompactToken<CharT>::FormBoolean(bool boolean) {
+  type = Type::kBoolean;
+  data = Data::kBoolean;
+  boolean_data = boolean;
+}
+}  // namespace json::token
@@ -0,0 +1,264 @@
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include "json/utils/char_class.h"
+#include "json/utils/letters.h"
+#include "json/utils/unicode.h"
+
+namespace json::token {
+/**
+ * @brief Decode the escape sequences of strings
+ *
+ * `Decode` decodes a whole sequence out of contiguous letters. `Feed` takes
+ * one letter at a time, so that decoding can stop and resume anywhere inside
+ * a sequence.
+ *
+ * `\u` escapes are written as utf8, utf16 or utf32 depending on the size of
+ * `CharT`, surrogate pairs written as two escapes are combined. Surrogates
+ * that are not part of a pair are replaced with U+FFFD.
+ */
+template <typename CharT>
+class EscapeDecoder {
+ public:
+  /**
+   * @brief Outcome of feeding a letter
+   */
+  enum class Status {
+    /**
+     * @brief The letter is part of the sequence, which needs more letters
+     */
+    kMore,
+    /**
+     * @brief The letter completed the sequence
+     */
+    kDone,
+    /**
+     * @brief The sequence completed before the letter, which is not part of
+     * it and still needs to be handled
+     */
+    kDoneBefore,
+    /**
+     * @brief The letter cannot be part of the sequence
+     */
+    kInvalid,
+  };
+
+  /**
+   * @brief Decode the next letter of a sequence, the first letter being the
+   * one after the backslash
+   * @param letter the letter
+   * @param buffer the string to append the decoded letters to
+   * @returns the outcome
+   */
+  Status Feed(CharT letter, std::basic_string<CharT> &buffer);
+
+  /**
+   * @brief Decode a whole sequence, parsing the 4 digits of `\u` escapes at
+   * once
+   * @param begin pointer to the letter after the backslash
+   * @param end pointer past the last letter available
+   * @param buffer the string to append the decoded letters to
+   * @returns pointer past the sequence, `nullptr` if the sequence is invalid
+   * or cut by `end`
+   */
+  static const CharT *Decode(const CharT *begin, const CharT *end,
+                             std::basic_string<CharT> &buffer);
+
+ private:
+  enum class State {
+    kStart,
+    kHex,
+    kLowBackslash,
+    kLowU,
+    kLowHex,
+  };
+
+  /**
+   * @brief Get the value of 4 hex digits
+   * @returns the value, -1 if a letter is not a hex digit
+   */
+  static int32_t Hex4(const CharT *letters);
+
+  /**
+   * @brief Handle a `\u` unit once its 4 digits have been fed
+   */
+  Status Unit(std::basic_string<CharT> &buffer);
+
+  State state_ = State::kStart;
+  int8_t digits_ = 0;
+  uint32_t unit_ = 0;
+  uint32_t high_ = 0;
+};
+}  // namespace json::token
+
+// Implementations
+
+namespace json::token {
+template <typename CharT>
+typename EscapeDecoder<CharT>::Status EscapeDecoder<CharT>::Feed(
+    CharT letter, std::basic_string<CharT> &buffer) {
+  using namespace json::utils;
+
+  switch (state_) {
+    case State::kStart: {
+      const char_class::Entry &entry = char_class::Lookup(letter);
+
+      if (entry.escaped != 0) {
+        buffer += CharT(entry.escaped);
+        return Status::kDone;
+      }
+
+      if (letter != letters::kU<CharT>) {
+        return Status::kInvalid;
+      }
+
+      state_ = State::kHex;
+      digits_ = 0;
+      unit_ = 0;
+      return Status::kMore;
+    }
+    case State::kHex:
+    case State::kLowHex: {
+      int32_t value = char_class::Lookup(letter).value;
+
+      if (value < 0) {
+        state_ = State::kStart;
+        return Status::kInvalid;
+      }
+
+      unit_ = (unit_ << 4) | uint32_t(value);
+
+      if (++digits_ < 4) {
+        return Status::kMore;
+      }
+
+      return Unit(buffer);
+    }
+    case State::kLowBackslash:
+      if (letter == letters::kBackSolidus<CharT>) {
+        state_ = State::kLowU;
+        return Status::kMore;
+      }
+
+      unicode::Append(unicode::kReplacement, buffer);
+      state_ = State::kStart;
+      return Status::kDoneBefore;
+    case State::kLowU:
+      if (letter == letters::kU<CharT>) {
+        state_ = State::kLowHex;
+        digits_ = 0;
+        unit_ = 0;
+        return Status::kMore;
+      }
+
+      // the high surrogate is followed by another kind of escape
+      unicode::Append(unicode::kReplacement, buffer);
+      state_ = State::kStart;
+      return Feed(letter, buffer);
+  }
+
+  return Status::kInvalid;
+}
+
+template <typename CharT>
+typename EscapeDecoder<CharT>::Status EscapeDecoder<CharT>::Unit(
+    std::basic_string<CharT> &buffer) {
+  using namespace json::utils;
+
+  if (state_ == State::kLowHex) {
+    if (unicode::IsLowSurrogate(unit_)) {
+      unicode::Append(unicode::Combine(high_, unit_), buffer);
+      state_ = State::kStart;
+      return Status::kDone;
+    }
+
+    // the high surrogate is not followed by a low surrogate
+    unicode::Append(unicode::kReplacement, buffer);
+  }
+
+  if (unicode::IsHighSurrogate(unit_)) {
+    high_ = unit_;
+    state_ = State::kLowBackslash;
+    return Status::kMore;
+  }
+
+  unicode::Append(
+      unicode::IsLowSurrogate(unit_) ? unicode::kReplacement : unit_, buffer);
+  state_ = State::kStart;
+  return Status::kDone;
+}
+
+template <typename CharT>
+const CharT *EscapeDecoder<CharT>::Decode(const CharT *begin,
+                                          const CharT *end,
+                                          std::basic_string<CharT> &buffer) {
+  using namespace json::utils;
+
+  if (begin == end) {
+    return nullptr;
+  }
+
+  const char_class::Entry &entry = char_class::Lookup(*begin);
+
+  if (entry.escaped != 0) {
+    buffer += CharT(entry.escaped);
+    return begin + 1;
+  }
+
+  if (*begin != letters::kU<CharT> || end - begin < 5) {
+    return nullptr;
+  }
+
+  int32_t unit = Hex4(begin + 1);
+  const CharT *cursor = begin + 5;
+
+  if (unit < 0) {
+    return nullptr;
+  }
+
+  uint32_t code_point = uint32_t(unit);
+
+  if (unicode::IsHighSurrogate(code_point)) {
+    code_point = unicode::kReplacement;
+
+    // a low surrogate escape right after completes the pair, any other
+    // escape is decoded on its own
+    if (end - cursor >= 6 && cursor[0] == letters::kBackSolidus<CharT> &&
+        cursor[1] == letters::kU<CharT>) {
+      int32_t low = Hex4(cursor + 2);
+
+      if (low < 0) {
+        return nullptr;
+      }
+
+      if (unicode::IsLowSurrogate(uint32_t(low))) {
+        code_point = unicode::Combine(uint32_t(unit), uint32_t(low));
+        cursor += 6;
+      }
+    }
+  } else if (unicode::IsLowSurrogate(code_point)) {
+    code_point = unicode::kReplacement;
+  }
+
+  unicode::Append(code_point, buffer);
+  return cursor;
+}
+
+template <typename CharT>
+int32_t EscapeDecoder<CharT>::Hex4(const CharT *letters) {
+  using utils::char_class::Lookup;
+
+  int32_t a = Lookup(letters[0]).value;
+  int32_t b = Lookup(letters[1]).value;
+  int32_t c = Lookup(letters[2]).value;
+  int32_t d = Lookup(letters[3]).value;
+
+  // invalid digits are -1, which sets the sign bit
+  if ((a | b | c | d) < 0) {
+    return -1;
+  }
+
+  return (a << 12) | (b << 8) | (c << 4) | d;
+}
+}  // namespace json::token
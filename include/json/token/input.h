@@ -0,0 +1,296 @@
+#pragma once
+
+#include <cstddef>
+#include <istream>
+#include <string>
+#include <string_view>
+#include "json/token/structural_index.h"
+
+namespace json::token {
+/**
+ * @brief Input that reads letters out of a std::basic_istream
+ *
+ * Every letter goes through the stream buffer of the stream, use
+ * `BufferInput` when the whole input is already in memory.
+ */
+template <typename CharT>
+class StreamInput {
+ public:
+  /**
+   * @brief The input does not expose a contiguous range of letters
+   */
+  static constexpr bool kContiguous = false;
+
+  /**
+   * @brief The input does not come with a structural index
+   */
+  static constexpr bool kIndexed = false;
+
+  /**
+   * @brief Create an input that reads from a stream
+   * @param stream the stream to read from, must outlive the input
+   */
+  StreamInput(std::basic_istream<CharT> &stream);
+
+  /**
+   * @brief Determine if all the letters have been read
+   * @returns `true` if the next letter is eof, `false` otherwise
+   */
+  bool Done();
+
+  /**
+   * @brief Look at the next letter without consuming it
+   * @returns the next letter
+   */
+  CharT Peek();
+
+  /**
+   * @brief Consume the next letter
+   * @returns the letter consumed
+   */
+  CharT Get();
+
+  /**
+   * @brief Number of letters consumed, asked to the stream
+   * @returns the number of letters, `size_t(-1)` if the stream cannot tell
+   */
+  size_t offset();
+
+ private:
+  std::basic_istream<CharT> &stream_;
+};
+
+/**
+ * @brief Input that reads letters out of a contiguous range in memory
+ *
+ * The input does not own the letters, the range must outlive the input.
+ */
+template <typename CharT>
+class BufferInput {
+ public:
+  /**
+   * @brief The input exposes a contiguous range of letters
+   */
+  static constexpr bool kContiguous = true;
+
+  /**
+   * @brief The input does not come with a structural index
+   */
+  static constexpr bool kIndexed = false;
+
+  /**
+   * @brief Create an input over [begin, end)
+   * @param begin pointer to the first letter
+   * @param end pointer past the last letter
+   */
+  BufferInput(const CharT *begin, const CharT *end);
+
+  /**
+   * @brief Create an input over a string view
+   * @param view the letters to read
+   */
+  BufferInput(std::basic_string_view<CharT> view);
+
+  /**
+   * @brief Determine if all the letters have been read
+   * @returns `true` if there are no letters left, `false` otherwise
+   */
+  bool Done() const;
+
+  /**
+   * @brief Look at the next letter without consuming it
+   * @returns the next letter
+   */
+  CharT Peek() const;
+
+  /**
+   * @brief Consume the next letter
+   * @returns the letter consumed
+   */
+  CharT Get();
+
+  /**
+   * @brief Pointer to the first letter of the input
+   */
+  const CharT *begin() const;
+
+  /**
+   * @brief Pointer to the next letter to be read
+   */
+  const CharT *cursor() const;
+
+  /**
+   * @brief Pointer past the last letter of the input
+   */
+  const CharT *end() const;
+
+  /**
+   * @brief Move the cursor to a position inside the input
+   * @param position the new position, must be in [begin, end]
+   */
+  void Seek(const CharT *position);
+
+ private:
+  const CharT *begin_;
+  const CharT *cursor_;
+  const CharT *end_;
+};
+
+/**
+ * @brief Input over a contiguous range that comes with the structural index
+ * of the range, used to jump from one token start to the next
+ *
+ * Neither the range nor the index is owned, both must outlive the input.
+ */
+template <typename CharT>
+class IndexedInput : public BufferInput<CharT> {
+ public:
+  /**
+   * @brief The input comes with a structural index
+   */
+  static constexpr bool kIndexed = true;
+
+  /**
+   * @brief Create an input over [begin, end)
+   * @param begin pointer to the first letter
+   * @param end pointer past the last letter
+   * @param index the index built from the same range
+   */
+  IndexedInput(const CharT *begin, const CharT *end,
+               const StructuralIndex &index);
+
+  /**
+   * @brief Create an input over a string view
+   * @param view the letters to read
+   * @param index the index built from the same letters
+   */
+  IndexedInput(std::basic_string_view<CharT> view,
+               const StructuralIndex &index);
+
+  /**
+   * @brief Move the cursor to the next token start after the cursor
+   * @returns `true` if there is a token start left, `false` otherwise
+   */
+  bool SeekStructural();
+
+  /**
+   * @brief Determine if all the token starts have been visited
+   * @returns `true` if no token start is left, `false` otherwise
+   */
+  bool StructuralsDone() const;
+
+ private:
+  const StructuralIndex &index_;
+  size_t next_;
+};
+}  // namespace json::token
+
+// Implementations
+
+namespace json::token {
+template <typename CharT>
+StreamInput<CharT>::StreamInput(std::basic_istream<CharT> &stream)
+    : stream_(stream) {}
+
+template <typename CharT>
+bool StreamInput<CharT>::Done() {
+  // can't directly use eof() method here.
+  // eof() would only return true after eof has been read.
+  // However, this method is supposed to return true when it sees eof()
+  return stream_.peek() == std::char_traits<CharT>::eof();
+}
+
+template <typename CharT>
+CharT StreamInput<CharT>::Peek() {
+  return std::char_traits<CharT>::to_char_type(stream_.peek());
+}
+
+template <typename CharT>
+CharT StreamInput<CharT>::Get() {
+  CharT letter;
+  stream_.get(letter);
+
+  return letter;
+}
+
+template <typename CharT>
+size_t StreamInput<CharT>::offset() {
+  return size_t(std::streamoff(stream_.tellg()));
+}
+
+template <typename CharT>
+BufferInput<CharT>::BufferInput(const CharT *begin, const CharT *end)
+    : begin_(begin), cursor_(begin), end_(end) {}
+
+template <typename CharT>
+BufferInput<CharT>::BufferInput(std::basic_string_view<CharT> view)
+    : BufferInput(view.data(), view.data() + view.size()) {}
+
+template <typename CharT>
+bool BufferInput<CharT>::Done() const {
+  return cursor_ == end_;
+}
+
+template <typename CharT>
+CharT BufferInput<CharT>::Peek() const {
+  return *cursor_;
+}
+
+template <typename CharT>
+CharT BufferInput<CharT>::Get() {
+  return *cursor_++;
+}
+
+template <typename CharT>
+const CharT *BufferInput<CharT>::begin() const {
+  return begin_;
+}
+
+template <typename CharT>
+const CharT *BufferInput<CharT>::cursor() const {
+  return cursor_;
+}
+
+template <typename CharT>
+const CharT *BufferInput<CharT>::end() const {
+  return end_;
+}
+
+template <typename CharT>
+void BufferInput<CharT>::Seek(const CharT *position) {
+  cursor_ = position;
+}
+
+template <typename CharT>
+IndexedInput<CharT>::IndexedInput(const CharT *begin, const CharT *end,
+                                  const StructuralIndex &index)
+    : BufferInput<CharT>(begin, end), index_(index), next_(0) {}
+
+template <typename CharT>
+IndexedInput<CharT>::IndexedInput(std::basic_string_view<CharT> view,
+                                  const StructuralIndex &index)
+    : BufferInput<CharT>(view), index_(index), next_(0) {}
+
+template <typename CharT>
+bool IndexedInput<CharT>::SeekStructural() {
+  const CharT *cursor = this->cursor();
+
+  // skip the starts already consumed as part of a previous token
+  while (next_ < index_.size() && this->begin() + index_[next_] < cursor) {
+    ++next_;
+  }
+
+  if (next_ == index_.size()) {
+    this->Seek(this->end());
+    return false;
+  }
+
+  this->Seek(this->begin() + index_[next_++]);
+  return true;
+}
+
+template <typename CharT>
+bool IndexedInput<CharT>::StructuralsDone() const {
+  return next_ == index_.size();
+}
+}  // namespace json::token
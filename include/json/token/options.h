@@ -0,0 +1,51 @@
+#pragma once
+
+namespace json::token {
+/**
+ * @brief Opt-in behaviours of the tokenizer, all disabled by default
+ */
+struct Options {
+  /**
+   * @brief Keep the letters of numbers and convert them the first time the
+   * value is read
+   *
+   * Only applies to contiguous inputs. The number tokens, and the values
+   * built from them, reference the input, which must outlive them.
+   */
+  bool lazy_numbers = false;
+
+  /**
+   * @brief Reject strings that are not well formed utf8
+   *
+   * Only applies to `char` inputs. The letters of strings are checked as
+   * they are scanned, letters outside of strings must be ascii anyway.
+   */
+  bool validate_utf8 = false;
+
+  /**
+   * @brief Accept line and block comments, which are skipped like
+   * whitespaces
+   *
+   * Not supported by `IndexedInput`, the structural index does not know
+   * about comments.
+   */
+  bool comments = false;
+
+  /**
+   * @brief Produce a comment token for every comment instead of skipping it,
+   * requires `comments`
+   *
+   * The tokens hold the text between the comment markers. On contiguous
+   * inputs they reference the input, which must outlive them.
+   */
+  bool comment_tokens = false;
+
+  /**
+   * @brief Skip the record separators (U+001E) that start the values of a
+   * json text sequence, see RFC 7464, like whitespaces
+   *
+   * Not supported by `PushTokenizer`.
+   */
+  bool record_separators = false;
+};
+}  // namespace json::token
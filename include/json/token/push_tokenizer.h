@@ -0,0 +1,508 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include "json/token/escape.h"
+#include "json/token/options.h"
+#include "json/token/token.h"
+#include "json/utils/char_class.h"
+#include "json/utils/convert.h"
+#include "json/utils/error_code.h"
+#include "json/utils/letters.h"
+#include "json/utils/simd.h"
+#include "json/utils/utf8.h"
+
+namespace json::token {
+/**
+ * @brief Tokenizer that is pushed chunks of letters as they arrive and hands
+ * every complete token to a sink
+ *
+ * A token can span any number of chunks: the tokenizer keeps the state of a
+ * string, number or literal cut at the end of a chunk and resumes it with the
+ * next chunk. The chunks do not need to outlive the call to `Feed`.
+ *
+ * The sink needs a `take(const Token<CharT> &)` method, such as
+ * `parser::Parser<CharT>`.
+ */
+template <typename CharT, typename SinkT>
+class PushTokenizer {
+ public:
+  /**
+   * @brief Create a tokenizer that hands tokens to a sink
+   * @param sink the sink, must outlive the tokenizer
+   * @param options opt-in behaviours of the tokenizer, lazy numbers do not
+   * apply as the chunks do not outlive `Feed`
+   */
+  PushTokenizer(SinkT &sink, const Options &options = {});
+
+  /**
+   * @brief Tokenize the next chunk of the input
+   * @param chunk pointer to the first letter of the chunk
+   * @param size number of letters in the chunk
+   * @returns `false` if an error has been found, `true` otherwise
+   */
+  bool Feed(const CharT *chunk, size_t size);
+
+  /**
+   * @brief Mark the end of the input, completing a number cut at the end of
+   * the last chunk
+   * @returns `false` if an error has been found or the input ended in the
+   * middle of a token, `true` otherwise
+   */
+  bool Finish();
+
+  /**
+   * @brief Get the error that stopped the tokenizer
+   * @returns the error, `ErrorCode::kNone` if there is none
+   */
+  utils::ErrorCode error() const;
+
+ private:
+  /**
+   * @brief Where the tokenizer stopped at the end of the previous chunk
+   */
+  enum class State {
+    kStart,
+    kString,
+    kEscape,
+    kNumber,
+    kLiteral,
+    kAfterLiteral,
+    kCommentStart,
+    kLineComment,
+    kBlockComment,
+    kBlockStar,
+  };
+
+  const CharT *Start(const CharT *cursor);
+  const CharT *String(const CharT *cursor, const CharT *end);
+  const CharT *Number(const CharT *cursor, const CharT *end);
+  const CharT *Literal(const CharT *cursor, const CharT *end);
+  const CharT *Comment(const CharT *cursor, const CharT *end);
+
+  /**
+   * @brief Convert the letters of the buffer to a number and hand it to the
+   * sink
+   * @returns `false` if the letters are not a json number
+   */
+  bool EmitNumber();
+
+  /**
+   * @brief Hand the current token to the sink
+   */
+  void Emit();
+
+  /**
+   * @brief Record an error, after which all the input is ignored
+   */
+  void Fail(utils::ErrorCode error);
+
+  SinkT &sink_;
+  Options options_;
+  Token<CharT> token_;
+  State state_ = State::kStart;
+  std::basic_string<CharT> buffer_;
+  // start of the letters of the buffer copied from the input since the last
+  // escape, a letter can be cut across chunks so they are checked for utf8
+  // once complete
+  size_t run_ = 0;
+  EscapeDecoder<CharT> decoder_;
+  const char *literal_ = nullptr;
+  size_t matched_ = 0;
+  utils::ErrorCode error_ = utils::ErrorCode::kNone;
+};
+}  // namespace json::token
+
+// Implementations
+
+namespace json::token {
+template <typename CharT, typename SinkT>
+PushTokenizer<CharT, SinkT>::PushTokenizer(SinkT &sink, const Options &options)
+    : sink_(sink), options_(options) {}
+
+template <typename CharT, typename SinkT>
+bool PushTokenizer<CharT, SinkT>::Feed(const CharT *chunk, size_t size) {
+  using namespace json::utils;
+  using Status = typename EscapeDecoder<CharT>::Status;
+
+  constexpr uint8_t kDelimiter =
+      char_class::kWhitespace | char_class::kStructural;
+
+  const CharT *cursor = chunk;
+  const CharT *end = chunk + size;
+
+  while (cursor != end && error_ == ErrorCode::kNone) {
+    switch (state_) {
+      case State::kStart:
+        cursor = Start(cursor);
+        break;
+      case State::kString:
+        cursor = String(cursor, end);
+        break;
+      case State::kEscape:
+        switch (decoder_.Feed(*cursor, buffer_)) {
+          case Status::kMore:
+            ++cursor;
+            break;
+          case Status::kDone:
+            ++cursor;
+            run_ = buffer_.size();
+            state_ = State::kString;
+            break;
+          case Status::kDoneBefore:
+            // the letter is handled as part of the string
+            run_ = buffer_.size();
+            state_ = State::kString;
+            break;
+          case Status::kInvalid:
+            Fail(ErrorCode::kInvalidEscape);
+            break;
+        }
+        break;
+      case State::kNumber:
+        cursor = Number(cursor, end);
+        break;
+      case State::kLiteral:
+        cursor = Literal(cursor, end);
+        break;
+      case State::kAfterLiteral:
+        // `truex` or `null1` are not literals
+        if (!char_class::Is(*cursor, kDelimiter) &&
+            !(options_.comments && *cursor == letters::kSolidus<CharT>)) {
+          Fail(ErrorCode::kInvalidLiteral);
+          break;
+        }
+
+        Emit();
+        state_ = State::kStart;
+        break;
+      case State::kCommentStart:
+      case State::kLineComment:
+      case State::kBlockComment:
+      case State::kBlockStar:
+        cursor = Comment(cursor, end);
+        break;
+    }
+  }
+
+  return error_ == ErrorCode::kNone;
+}
+
+template <typename CharT, typename SinkT>
+bool PushTokenizer<CharT, SinkT>::Finish() {
+  using namespace json::utils;
+
+  if (error_ != ErrorCode::kNone) {
+    return false;
+  }
+
+  switch (state_) {
+    case State::kStart:
+      break;
+    case State::kAfterLiteral:
+      Emit();
+      break;
+    case State::kLineComment:
+      if (options_.comment_tokens) {
+        token_.FormComment(std::move(buffer_));
+        buffer_.clear();
+        Emit();
+      }
+      break;
+    case State::kNumber:
+      if (!EmitNumber()) {
+        return false;
+      }
+      break;
+    default:
+      Fail(ErrorCode::kUnexpectedEnd);
+      return false;
+  }
+
+  state_ = State::kStart;
+  return true;
+}
+
+template <typename CharT, typename SinkT>
+utils::ErrorCode PushTokenizer<CharT, SinkT>::error() const {
+  return error_;
+}
+
+template <typename CharT, typename SinkT>
+const CharT *PushTokenizer<CharT, SinkT>::Start(const CharT *cursor) {
+  using namespace json::utils;
+  using char_class::Dispatch;
+  using TType = typename Token<CharT>::Type;
+
+  switch (char_class::Lookup(*cursor).dispatch) {
+    case Dispatch::kWhitespace:
+      return cursor + 1;
+    case Dispatch::kBeginObject:
+      token_.type = TType::kBeginObject;
+      Emit();
+      return cursor + 1;
+    case Dispatch::kEndObject:
+      token_.type = TType::kEndObject;
+      Emit();
+      return cursor + 1;
+    case Dispatch::kBeginArray:
+      token_.type = TType::kBeginArray;
+      Emit();
+      return cursor + 1;
+    case Dispatch::kEndArray:
+      token_.type = TType::kEndArray;
+      Emit();
+      return cursor + 1;
+    case Dispatch::kValueSeparator:
+      token_.type = TType::kValueSeparator;
+      Emit();
+      return cursor + 1;
+    case Dispatch::kKeyValueSeparator:
+      token_.type = TType::kKeyValueSeparator;
+      Emit();
+      return cursor + 1;
+    case Dispatch::kString:
+      buffer_.clear();
+      run_ = 0;
+      state_ = State::kString;
+      return cursor + 1;
+    case Dispatch::kNumber:
+      buffer_.clear();
+      state_ = State::kNumber;
+      return cursor;
+    case Dispatch::kTrue:
+      literal_ = "true";
+      break;
+    case Dispatch::kFalse:
+      literal_ = "false";
+      break;
+    case Dispatch::kNull:
+      literal_ = "null";
+      break;
+    case Dispatch::kComment:
+      if (!options_.comments) {
+        Fail(ErrorCode::kUnexpectedLetter);
+        return cursor;
+      }
+
+      buffer_.clear();
+      state_ = State::kCommentStart;
+      return cursor + 1;
+    case Dispatch::kInvalid:
+      Fail(ErrorCode::kUnexpectedLetter);
+      return cursor;
+  }
+
+  matched_ = 0;
+  state_ = State::kLiteral;
+  return cursor;
+}
+
+template <typename CharT, typename SinkT>
+const CharT *PushTokenizer<CharT, SinkT>::String(const CharT *cursor,
+                                                 const CharT *end) {
+  using namespace json::utils;
+
+  // copy the run of letters up to the next quote or backslash at once
+  const CharT *stop = simd::FindQuoteOrBackslash(cursor, end);
+  buffer_.append(cursor, stop);
+
+  if (stop == end) {
+    return end;
+  }
+
+  if constexpr (sizeof(CharT) == 1) {
+    if (options_.validate_utf8 &&
+        !utf8::Validate(reinterpret_cast<const char *>(buffer_.data() + run_),
+                        reinterpret_cast<const char *>(buffer_.data() +
+                                                       buffer_.size()))) {
+      Fail(ErrorCode::kInvalidUtf8);
+      return stop;
+    }
+  }
+
+  if (*stop == letters::kDoubleQuote<CharT>) {
+    token_.FormString(std::move(buffer_));
+    buffer_.clear();
+    Emit();
+    state_ = State::kStart;
+  } else {
+    state_ = State::kEscape;
+  }
+
+  return stop + 1;
+}
+
+template <typename CharT, typename SinkT>
+const CharT *PushTokenizer<CharT, SinkT>::Number(const CharT *cursor,
+                                                 const CharT *end) {
+  using namespace json::utils;
+
+  const CharT *stop = cursor;
+
+  while (stop != end && char_class::Is(*stop, char_class::kNumber)) {
+    ++stop;
+  }
+
+  buffer_.append(cursor, stop);
+
+  // the number may go on in the next chunk
+  if (stop == end) {
+    return end;
+  }
+
+  EmitNumber();
+  state_ = State::kStart;
+
+  return stop;
+}
+
+template <typename CharT, typename SinkT>
+const CharT *PushTokenizer<CharT, SinkT>::Literal(const CharT *cursor,
+                                                  const CharT *end) {
+  using TType = typename Token<CharT>::Type;
+
+  for (; cursor != end && literal_[matched_] != 0; ++cursor, ++matched_) {
+    if (*cursor != CharT(literal_[matched_])) {
+      Fail(utils::ErrorCode::kInvalidLiteral);
+      return cursor;
+    }
+  }
+
+  if (literal_[matched_] != 0) {
+    return cursor;
+  }
+
+  switch (literal_[0]) {
+    case 't':
+      token_.FormBoolean(true);
+      break;
+    case 'f':
+      token_.FormBoolean(false);
+      break;
+    default:
+      token_.type = TType::kNull;
+      break;
+  }
+
+  // handed to the sink once the delimiter is seen
+  state_ = State::kAfterLiteral;
+
+  return cursor;
+}
+
+template <typename CharT, typename SinkT>
+const CharT *PushTokenizer<CharT, SinkT>::Comment(const CharT *cursor,
+                                                  const CharT *end) {
+  using namespace json::utils;
+  using Traits = std::char_traits<CharT>;
+
+  // the text is only kept when comment tokens are asked for
+  bool keep = options_.comment_tokens;
+  const CharT *stop;
+
+  switch (state_) {
+    case State::kCommentStart:
+      if (*cursor == letters::kSolidus<CharT>) {
+        state_ = State::kLineComment;
+      } else if (*cursor == CharT('*')) {
+        state_ = State::kBlockComment;
+      } else {
+        Fail(ErrorCode::kUnexpectedLetter);
+        return cursor;
+      }
+
+      return cursor + 1;
+    case State::kLineComment:
+      stop = Traits::find(cursor, size_t(end - cursor),
+                          letters::kEndline<CharT>);
+      stop = stop == nullptr ? end : stop;
+
+      if (keep) {
+        buffer_.append(cursor, stop);
+      }
+
+      // the end of the line is left to be skipped as a whitespace
+      if (stop != end) {
+        if (keep) {
+          token_.FormComment(std::move(buffer_));
+          buffer_.clear();
+          Emit();
+        }
+
+        state_ = State::kStart;
+      }
+
+      return stop;
+    case State::kBlockComment:
+      stop = Traits::find(cursor, size_t(end - cursor), CharT('*'));
+      stop = stop == nullptr ? end : stop;
+
+      if (keep) {
+        buffer_.append(cursor, stop);
+      }
+
+      if (stop == end) {
+        return end;
+      }
+
+      state_ = State::kBlockStar;
+      return stop + 1;
+    default:
+      if (*cursor == letters::kSolidus<CharT>) {
+        if (keep) {
+          token_.FormComment(std::move(buffer_));
+          buffer_.clear();
+          Emit();
+        }
+
+        state_ = State::kStart;
+        return cursor + 1;
+      }
+
+      // the pending `*` was part of the text
+      if (keep) {
+        buffer_ += CharT('*');
+      }
+
+      // another `*` may start the end of the comment, as in `**/`
+      if (*cursor == CharT('*')) {
+        return cursor + 1;
+      }
+
+      // the letter is looked at again
+      state_ = State::kBlockComment;
+      return cursor;
+  }
+}
+
+template <typename CharT, typename SinkT>
+bool PushTokenizer<CharT, SinkT>::EmitNumber() {
+  using namespace json::utils::convert;
+
+  const CharT *begin = buffer_.data();
+  const CharT *end = begin + buffer_.size();
+  number::Decimal decimal;
+
+  // all the letters gathered must make the number
+  if (number::Scan(begin, end, decimal) != end) {
+    Fail(utils::ErrorCode::kInvalidNumber);
+    return false;
+  }
+
+  token_.FormValue(number::Convert(decimal, begin, end));
+  Emit();
+
+  return true;
+}
+
+template <typename CharT, typename SinkT>
+void PushTokenizer<CharT, SinkT>::Emit() {
+  sink_.take(token_);
+}
+
+template <typename CharT, typename SinkT>
+void PushTokenizer<CharT, SinkT>::Fail(utils::ErrorCode error) {
+  error_ = error;
+}
+}  // namespace json::token
@@ -0,0 +1,225 @@
+#pragma once
+
+#include <stdint.h>
+#include <cstddef>
+#include <vector>
+#include "json/utils/simd.h"
+
+namespace json::token {
+/**
+ * @brief Offsets of every token start in a json text
+ *
+ * The index records every structural letter (`{ } [ ] : ,`) and every
+ * opening quote that is not inside a string, plus the first letter of every
+ * number or literal. A tokenizer can then jump from one token to the next
+ * without looking at whitespaces or string contents.
+ *
+ * The offsets are kept as 32 bit integers to halve the size of the index, so
+ * only texts of less than 4GiB letters can be indexed.
+ */
+class StructuralIndex {
+ public:
+  /**
+   * @brief Largest number of letters of a text that can be indexed
+   */
+  static constexpr size_t kMaxLength = UINT32_MAX;
+
+  /**
+   * @brief Index a text, replacing the previous content of the index while
+   * keeping its capacity
+   * @param begin pointer to the first letter of the text
+   * @param end pointer past the last letter of the text
+   * @param isa instruction set used to scan `char` texts
+   * @returns `true` on success, `false` if the text has more than
+   * `kMaxLength` letters, in which case the index is left empty
+   */
+  template <typename CharT>
+  bool Build(const CharT *begin, const CharT *end,
+             utils::simd::Isa isa = utils::simd::DetectIsa());
+
+  /**
+   * @brief Number of offsets in the index
+   */
+  size_t size() const;
+
+  /**
+   * @brief Get an offset
+   * @param index position of the offset in the index
+   * @returns the offset of a token start, relative to the begin of the text
+   */
+  uint32_t operator[](size_t index) const;
+
+  /**
+   * @brief Get all the offsets
+   * @returns a reference to the offsets
+   */
+  const std::vector<uint32_t> &offsets() const;
+
+ private:
+  /**
+   * @brief State carried from one block to the next
+   */
+  struct Carry {
+    uint64_t odd_backslash = 0;
+    uint64_t in_string = 0;
+    uint64_t scalar = 0;
+  };
+
+  void Block(const utils::simd::BlockMasks &masks, uint64_t valid,
+             uint32_t base, Carry &carry);
+
+  std::vector<uint32_t> offsets_;
+};
+}  // namespace json::token
+
+// Implementations
+
+namespace json::token {
+namespace detail {
+/**
+ * @brief Find the letters preceded by an odd number of backslashes
+ * @param backslash bitmap of the backslashes in the block
+ * @param carry 1 if the previous block ended with an odd number of
+ * backslashes, set to the same property of this block
+ * @returns bitmap of the escaped letters
+ */
+inline uint64_t FindEscaped(uint64_t backslash, uint64_t &carry) {
+  constexpr uint64_t kEvenBits = 0x5555555555555555ULL;
+  constexpr uint64_t kOddBits = ~kEvenBits;
+
+  uint64_t start_edges = backslash & ~(backslash << 1);
+  uint64_t even_start_mask = kEvenBits ^ carry;
+  uint64_t even_starts = start_edges & even_start_mask;
+  uint64_t odd_starts = start_edges & ~even_start_mask;
+  uint64_t even_carries = backslash + even_starts;
+  uint64_t odd_carries = backslash + odd_starts;
+  bool ends_odd_backslash = odd_carries < backslash;
+
+  odd_carries |= carry;
+  carry = ends_odd_backslash ? 1 : 0;
+
+  uint64_t even_carry_ends = even_carries & ~backslash;
+  uint64_t odd_carry_ends = odd_carries & ~backslash;
+
+  return (even_carry_ends & kOddBits) | (odd_carry_ends & kEvenBits);
+}
+
+/**
+ * @brief Compute the xor of every bit with all the bits below it
+ */
+inline uint64_t PrefixXor(uint64_t bits) {
+  bits ^= bits << 1;
+  bits ^= bits << 2;
+  bits ^= bits << 4;
+  bits ^= bits << 8;
+  bits ^= bits << 16;
+  bits ^= bits << 32;
+
+  return bits;
+}
+
+/**
+ * @brief Classify a block of letters wider than a byte, letters outside of
+ * the ascii range are never of interest
+ */
+template <typename CharT>
+void ClassifyWide(const CharT *block, utils::simd::BlockMasks &masks) {
+  char narrow[64];
+
+  for (int i = 0; i < 64; ++i) {
+    narrow[i] = uint32_t(block[i]) < 128 ? char(block[i]) : 'x';
+  }
+
+  utils::simd::ClassifyScalar(narrow, masks);
+}
+}  // namespace detail
+
+template <typename CharT>
+bool StructuralIndex::Build(const CharT *begin, const CharT *end,
+                            utils::simd::Isa isa) {
+  utils::simd::Classifier classify = utils::simd::SelectClassifier(isa);
+  utils::simd::BlockMasks masks;
+  Carry carry;
+
+  size_t length = end - begin;
+  size_t full = length - length % 64;
+
+  offsets_.clear();
+
+  // the offsets of larger texts would wrap around
+  if (length > kMaxLength) {
+    return false;
+  }
+
+  for (size_t i = 0; i < full; i += 64) {
+    if constexpr (sizeof(CharT) == 1) {
+      classify(reinterpret_cast<const char *>(begin + i), masks);
+    } else {
+      detail::ClassifyWide(begin + i, masks);
+    }
+
+    Block(masks, ~uint64_t{0}, uint32_t(i), carry);
+  }
+
+  if (full != length) {
+    // pad the last block with spaces
+    CharT tail[64];
+
+    for (size_t i = 0; i < 64; ++i) {
+      tail[i] = full + i < length ? begin[full + i] : CharT(' ');
+    }
+
+    if constexpr (sizeof(CharT) == 1) {
+      classify(reinterpret_cast<const char *>(tail), masks);
+    } else {
+      detail::ClassifyWide(tail, masks);
+    }
+
+    Block(masks, (uint64_t{1} << (length - full)) - 1, uint32_t(full), carry);
+  }
+
+  return true;
+}
+
+inline void StructuralIndex::Block(const utils::simd::BlockMasks &masks,
+                                   uint64_t valid, uint32_t base,
+                                   Carry &carry) {
+  uint64_t escaped = masks.backslash == 0 && carry.odd_backslash == 0
+                         ? 0
+                         : detail::FindEscaped(masks.backslash,
+                                               carry.odd_backslash);
+  uint64_t quote = masks.quote & ~escaped;
+
+  // set from an opening quote up to, but excluding, its closing quote
+  uint64_t in_string = detail::PrefixXor(quote) ^ carry.in_string;
+  carry.in_string = uint64_t(int64_t(in_string) >> 63);
+
+  uint64_t structural = masks.structural & ~in_string;
+  uint64_t opening_quote = quote & in_string;
+
+  // first letter of every number or literal
+  uint64_t scalar =
+      ~(masks.whitespace | masks.structural | quote | in_string) & valid;
+  uint64_t scalar_start = scalar & ~((scalar << 1) | carry.scalar);
+  carry.scalar = scalar >> 63;
+
+  uint64_t bits = structural | opening_quote | scalar_start;
+
+  while (bits != 0) {
+    offsets_.push_back(base + uint32_t(utils::simd::TrailingZeros(bits)));
+    bits &= bits - 1;
+  }
+}
+
+inline size_t StructuralIndex::size() const {
+  return offsets_.size();
+}
+
+inline uint32_t StructuralIndex::operator[](size_t index) const {
+  return offsets_[index];
+}
+
+inline const std::vector<uint32_t> &StructuralIndex::offsets() const {
+  return offsets_;
+}
+}  // namespace json::token
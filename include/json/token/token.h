@@ -8,16 +8,19 @@
 
 #pragma once
 
+#include <stdint.h>
 #include <iostream>
+#include <limits>
 #include <string>
 #include <string_view>
 #include <utility>
 #include <variant>
+#include "json/utils/convert.h"
 
 namespace json::token {
 template <typename CharT>
 struct Token {
-  enum class Type {
+  enum class Type : uint8_t {
     kBeginObject,
     kEndObject,
     kBeginArray,
@@ -35,8 +38,17 @@ struct Token {
   using StringData = std::basic_string<CharT>;
   using NumberData = double;
   using BooleanData = bool;
+  using StringViewData = std::basic_string_view<CharT>;
+  using IntegerData = int64_t;
+  using UnsignedData = uint64_t;
 
-  using Data = std::variant<StringData, NumberData, BooleanData>;
+  using Data = std::variant<StringData, NumberData, BooleanData, StringViewData,
+                            IntegerData, UnsignedData>;
+
+  /**
+   * Largest number of letters of a string, comment or raw number
+   */
+  static constexpr size_t kMaxLength = std::numeric_limits<size_t>::max();
 
   /**
    * Create a token with type initialized to undefined.
@@ -77,16 +89,55 @@ struct Token {
   Token(const NumberData &num);
 
   /**
-   * Get a reference to the string data if the type is string or comment
-   * @returns a reference to the string data
+   * Get the string data if the type is string or comment, whether the token
+   * owns the string or references the input
+   * @returns a view of the string data
+   */
+  StringViewData string() const;
+
+  /**
+   * See if the string data references the input instead of being owned
+   * @returns `true` if the token holds a view, `false` otherwise
+   */
+  bool IsStringView() const;
+
+  /**
+   * Get the number data as a double, converting integers
+   * @returns the number data
+   */
+  NumberData number() const;
+
+  /**
+   * See if the number is an integer that fits in 64 bits
+   * @returns `true` if the number is an integer, `false` otherwise
+   */
+  bool IsInteger() const;
+
+  /**
+   * See if the number data is the letters of the number, referencing the
+   * input, instead of its value
+   * @returns `true` if the number is raw, `false` otherwise
+   */
+  bool IsRawNumber() const;
+
+  /**
+   * Get the value of the number data, converting the letters of a raw
+   * number
+   * @returns the value of the number
    */
-  const StringData &string() const;
+  utils::convert::number::Value NumberValue() const;
 
   /**
-   * Get a reference to the number data;
-   * @returns a reference to the number data
+   * Get the number data as a signed integer, converting other numbers
+   * @returns the number data
    */
-  const NumberData &number() const;
+  IntegerData int64() const;
+
+  /**
+   * Get the number data as an unsigned integer, converting other numbers
+   * @returns the number data
+   */
+  UnsignedData uint64() const;
 
   /**
    * Get a reference to the boolean data;
@@ -100,18 +151,73 @@ struct Token {
    */
   void FormString(StringData &&buffer);
 
+  /**
+   * Become a string token that references the input, the input must outlive
+   * the token
+   * @param view the letters of the string
+   */
+  void FormStringView(StringViewData view);
+
   /**
    * Become a comment token
    * @param buffer the buffer to give to the token
    */
   void FormComment(StringData &&buffer);
 
+  /**
+   * Become a string token out of the letters of a buffer, which are taken
+   * by the token and leave the buffer empty
+   * @param buffer the buffer holding the letters
+   */
+  void FormBufferString(StringData &buffer);
+
+  /**
+   * Become a comment token out of the letters of a buffer, which are taken
+   * by the token and leave the buffer empty
+   * @param buffer the buffer holding the letters
+   */
+  void FormBufferComment(StringData &buffer);
+
+  /**
+   * Become a comment token that references the input, the input must outlive
+   * the token
+   * @param view the letters of the comment
+   */
+  void FormCommentView(StringViewData view);
+
   /**
    * Become a number token
    * @param number the number to give to the token
    */
   void FormNumber(NumberData number);
 
+  /**
+   * Become an integer number token
+   * @param integer the number to give to the token
+   */
+  void FormInteger(IntegerData integer);
+
+  /**
+   * Become an unsigned integer number token, for integers larger than the
+   * largest signed integer
+   * @param integer the number to give to the token
+   */
+  void FormUnsigned(UnsignedData integer);
+
+  /**
+   * Become a number token holding a converted value, integers keep their
+   * exact value
+   * @param value the value to give to the token
+   */
+  void FormValue(const utils::convert::number::Value &value);
+
+  /**
+   * Become a number token that keeps the letters of the number, the input
+   * must outlive the token
+   * @param text the letters of the number
+   */
+  void FormRawNumber(StringViewData text);
+
   /**
    * Become a bolean
    * @param boolean the value to give to the token
@@ -168,11 +274,26 @@ inline std::ostream &operator<<(std::ostream &out, const Token<char> &token) {
   switch (token.type) {
     case TType::kString:
       out << "string=";
-      out << get<0>(token.data);
+      out << token.string();
       break;
     case TType::kNumber:
       out << "number";
-      out << get<1>(token.data);
+
+      switch (token.data.index()) {
+        case 3:
+          out << get<3>(token.data);
+          break;
+        case 4:
+          out << get<4>(token.data);
+          break;
+        case 5:
+          out << get<5>(token.data);
+          break;
+        default:
+          out << token.number();
+          break;
+      }
+
       break;
     case TType::kBoolean:
       out << "boolean";
@@ -195,7 +316,7 @@ inline std::ostream &operator<<(std::ostream &out, const Token<char> &token) {
       break;
     case TType::kComment:
       out << "comment";
-      out << get<0>(token.data);
+      out << token.string();
       break;
     case TType::kUninitialized:
       out << "?";
@@ -230,19 +351,8 @@ Token<CharT>::Token(const Token<CharT> &other)
  * @param other another token
  */
 template <typename CharT>
-Token<CharT>::Token(Token<CharT> &&other) : type(other.type) {
-  switch (type) {
-    case Type::kString:
-    case Type::kComment:
-      data.template emplace<0>(std::move(std::get<0>(other.data)));
-      break;
-    case Type::kNumber:
-      data = other.data;
-      break;
-    default:
-      break;
-  }
-}
+Token<CharT>::Token(Token<CharT> &&other)
+    : type(other.type), data(std::move(other.data)) {}
 
 /**
  * Create a token of a specific type
@@ -288,20 +398,48 @@ Token<CharT>::Token(const NumberData &num) : type(Type::kNumber), data(num) {}
  */
 template <typename CharT>
 void Token<CharT>::FormString(StringData &&buffer) {
-  type = Type::string;
+  type = Type::kString;
   data.template emplace<0>(std::move(buffer));
 }
 
+/**
+ * Become a string token that references the input
+ * @param view the letters of the string
+ */
+template <typename CharT>
+void Token<CharT>::FormStringView(StringViewData view) {
+  type = Type::kString;
+  data.template emplace<3>(view);
+}
+
 /**
  * Become a comment token
  * @param buffer the buffer to give to the token
  */
 template <typename CharT>
 void Token<CharT>::FormComment(StringData &&buffer) {
-  type = Type::comment;
+  type = Type::kComment;
   data.template emplace<0>(std::move(buffer));
 }
 
+template <typename CharT>
+void Token<CharT>::FormBufferString(StringData &buffer) {
+  FormString(std::move(buffer));
+  buffer.clear();
+}
+
+template <typename CharT>
+void Token<CharT>::FormBufferComment(StringData &buffer) {
+  FormComment(std::move(buffer));
+  buffer.clear();
+}
+
+template <typename CharT>
+void Token<CharT>::FormCommentView(StringViewData view) {
+  type = Type::kComment;
+  data.template emplace<3>(view);
+}
+
 /**
  * Become a number token
  * @param number the buffer to give to the token
@@ -312,6 +450,48 @@ void Token<CharT>::FormNumber(NumberData number) {
   data.template emplace<1>(number);
 }
 
+/**
+ * Become an integer number token
+ * @param integer the number to give to the token
+ */
+template <typename CharT>
+void Token<CharT>::FormInteger(IntegerData integer) {
+  type = Type::kNumber;
+  data.template emplace<4>(integer);
+}
+
+/**
+ * Become an unsigned integer number token
+ * @param integer the number to give to the token
+ */
+template <typename CharT>
+void Token<CharT>::FormUnsigned(UnsignedData integer) {
+  type = Type::kNumber;
+  data.template emplace<5>(integer);
+}
+
+template <typename CharT>
+void Token<CharT>::FormValue(const utils::convert::number::Value &value) {
+  switch (value.index()) {
+    case 1:
+      return FormInteger(std::get<1>(value));
+    case 2:
+      return FormUnsigned(std::get<2>(value));
+    default:
+      return FormNumber(std::get<0>(value));
+  }
+}
+
+/**
+ * Become a number token that keeps the letters of the number
+ * @param text the letters of the number
+ */
+template <typename CharT>
+void Token<CharT>::FormRawNumber(StringViewData text) {
+  type = Type::kNumber;
+  data.template emplace<3>(text);
+}
+
 /**
  * Become a bolean
  * @param boolean the value to give to the token
@@ -323,21 +503,126 @@ void Token<CharT>::FormBoolean(BooleanData boolean) {
 }
 
 /**
- * Get a reference to the string data if the type is string or comment
- * @returns a reference to the string data
+ * Get the string data if the type is string or comment
+ * @returns a view of the string data
  */
 template <typename CharT>
-const typename Token<CharT>::StringData &Token<CharT>::string() const {
+typename Token<CharT>::StringViewData Token<CharT>::string() const {
+  if (data.index() == 3) {
+    return std::get<3>(data);
+  }
+
   return std::get<0>(data);
 }
 
 /**
- * Get a reference to the number data;
- * @returns a reference to the number data
+ * See if the string data references the input instead of being owned
+ * @returns `true` if the token holds a view, `false` otherwise
+ */
+template <typename CharT>
+bool Token<CharT>::IsStringView() const {
+  return data.index() == 3;
+}
+
+/**
+ * Get the number data as a double, converting integers
+ * @returns the number data
  */
 template <typename CharT>
-const typename Token<CharT>::NumberData &Token<CharT>::number() const {
-  return std::get<1>(data);
+typename Token<CharT>::NumberData Token<CharT>::number() const {
+  switch (data.index()) {
+    case 3:
+      return std::visit([](auto value) { return NumberData(value); },
+                        NumberValue());
+    case 4:
+      return NumberData(std::get<4>(data));
+    case 5:
+      return NumberData(std::get<5>(data));
+    default:
+      return std::get<1>(data);
+  }
+}
+
+/**
+ * See if the number data is stored as a 64 bit integer
+ * @returns `true` if the number is an integer, `false` otherwise
+ */
+template <typename CharT>
+bool Token<CharT>::IsInteger() const {
+  if (data.index() == 3) {
+    return NumberValue().index() != 0;
+  }
+
+  return data.index() == 4 || data.index() == 5;
+}
+
+/**
+ * See if the number data is the letters of the number
+ * @returns `true` if the number is raw, `false` otherwise
+ */
+template <typename CharT>
+bool Token<CharT>::IsRawNumber() const {
+  return type == Type::kNumber && data.index() == 3;
+}
+
+/**
+ * Get the value of the number data
+ * @returns the value of the number
+ */
+template <typename CharT>
+utils::convert::number::Value Token<CharT>::NumberValue() const {
+  using namespace utils::convert;
+
+  switch (data.index()) {
+    case 3: {
+      StringViewData text = std::get<3>(data);
+      return number::Parse(text.data(), text.data() + text.size());
+    }
+    case 4:
+      return std::get<4>(data);
+    case 5:
+      return std::get<5>(data);
+    default:
+      return std::get<1>(data);
+  }
+}
+
+/**
+ * Get the number data as a signed integer, converting other numbers
+ * @returns the number data
+ */
+template <typename CharT>
+typename Token<CharT>::IntegerData Token<CharT>::int64() const {
+  switch (data.index()) {
+    case 3:
+      return std::visit([](auto value) { return IntegerData(value); },
+                        NumberValue());
+    case 4:
+      return std::get<4>(data);
+    case 5:
+      return IntegerData(std::get<5>(data));
+    default:
+      return IntegerData(std::get<1>(data));
+  }
+}
+
+/**
+ * Get the number data as an unsigned integer, converting other numbers
+ * @returns the number data
+ */
+template <typename CharT>
+typename Token<CharT>::UnsignedData Token<CharT>::uint64() const {
+  switch (data.index()) {
+    case 3:
+      return std::visit([](auto value) { return UnsignedData(value); },
+                        NumberValue());
+    case 4:
+      return UnsignedData(std::get<4>(data));
+    case 5:
+      return std::get<5>(data);
+    default:
+      return UnsignedData(std::get<1>(data));
+  }
 }
 
 /**
@@ -357,8 +642,20 @@ template <typename CharT>
 bool Token<CharT>::operator==(const Token<CharT> &other) const {
   switch (type) {
     case Type::kString:
-    case Type::kBoolean:
+    case Type::kComment:
+      return (other.type == type) && (other.string() == string());
     case Type::kNumber:
+      if (other.type != type) {
+        return false;
+      }
+
+      // integers and doubles of the same value are the same number
+      if (other.data.index() != data.index()) {
+        return other.number() == number();
+      }
+
+      return other.data == data;
+    case Type::kBoolean:
       return (other.type == type) && (other.data == data);
     default:
       return type == other.type;
@@ -371,6 +668,6 @@ bool Token<CharT>::operator==(const Token<CharT> &other) const {
  */
 template <typename CharT>
 bool Token<CharT>::operator!=(const Token<CharT> &other) const {
-  return (other.type != type) || (other.data != data);
+  return !(*this == other);
 }
 }  // namespace json::token
@@ -8,20 +8,45 @@
 
 #pragma once
 
-#include <bitset>
-#include <cmath>
+#include <cstring>
 #include <istream>
 #include <string>
+#include "json/token/compact_token.h"
+#include "json/token/escape.h"
+#include "json/token/input.h"
+#include "json/token/options.h"
 #include "json/token/token.h"
+#include "json/utils/char_class.h"
 #include "json/utils/convert.h"
+#include "json/utils/error_code.h"
 #include "json/utils/letters.h"
+#include "json/utils/simd.h"
+#include "json/utils/utf8.h"
 
 namespace json::token {
-template <typename CharT>
+/**
+ * @brief Split letters read from an input into tokens
+ *
+ * By default the letters are read from a `std::basic_istream`, see
+ * `BufferTokenizer` to tokenize a contiguous range in memory.
+ *
+ * The tokens are `Token` by default, which own the letters they could not
+ * reference in the input. See `CompactTokenizer` to extract `CompactToken`
+ * instead, which reference a buffer of the tokenizer.
+ */
+template <typename CharT, typename InputT = StreamInput<CharT>,
+          typename TokenT = Token<CharT>>
 class Tokenizer {
  public:
-  using InputStream = std::basic_istream<CharT>;
-  Tokenizer(InputStream &input_stream);
+  using Input = InputT;
+  using TokenType = TokenT;
+
+  /**
+   * Create a tokenizer that reads from an input
+   * @param input the input to read from, a stream for the default input
+   * @param options opt-in behaviours of the tokenizer
+   */
+  Tokenizer(InputT input, const Options &options = {});
 
   /**
    * Take an input iterator to extract letter to process
@@ -31,13 +56,31 @@ class Tokenizer {
    */
   void Extract();
 
+  /**
+   * Determine if the tokenizer has nothing left to extract
+   * @returns `true` if the input is exhausted or an error was found
+   */
   bool Done();
 
+  /**
+   * Get the error that stopped the tokenizer
+   * @returns the error, `ErrorCode::kNone` if there is none
+   */
+  utils::ErrorCode error() const;
+
+  /**
+   * Get the number of letters consumed, which is the offset of the letter
+   * that caused the error once an error is found. Streams are asked for
+   * their position, see `StreamInput::offset`
+   * @returns the number of letters consumed
+   */
+  size_t offset();
+
   /**
    * Get a reference to the current token
    * @returns a reference to the current token
    */
-  Token<CharT> &token();
+  TokenT &token();
 
  private:
   void String();
@@ -46,126 +89,288 @@ class Tokenizer {
   void False();
   void Null();
 
-  Token<CharT> token_;
-  InputStream &input_stream_;
+  /**
+   * Skip a comment, or form a comment token when asked to by the options
+   * @returns `true` if the comment was skipped, `false` if a token was
+   * formed or an error recorded
+   */
+  bool Comment();
+
+  /**
+   * Consume a literal and check that the letter after it is a delimiter
+   * @param letters the literal
+   * @returns `true` on success, `false` after recording an error
+   */
+  template <size_t kSize>
+  bool Literal(const char (&letters)[kSize]);
+
+  /**
+   * Check that letters copied from the input are well formed utf8, when
+   * asked to by the options
+   * @returns `true` on success, `false` after recording an error
+   */
+  bool CheckUtf8(const CharT *begin, const CharT *end);
+
+  /**
+   * Check that the letters of a string, comment or raw number fit in a
+   * token, see `TokenT::kMaxLength`
+   * @returns `true` on success, `false` after recording an error
+   */
+  bool CheckLength(size_t length);
+
+  /**
+   * Record an error, after which the tokenizer is done
+   * @returns `false`
+   */
+  bool Fail(utils::ErrorCode error);
+
+  TokenT token_;
+  InputT input_;
+  Options options_;
+
+  /**
+   * @brief Letters that could not be referenced in the input, reused from
+   * one token to the next
+   */
+  std::basic_string<CharT> buffer_;
+  utils::ErrorCode error_ = utils::ErrorCode::kNone;
 };
+
+/**
+ * @brief Tokenizer that reads from a `const CharT *` range or a
+ * `std::basic_string_view`, without going through a stream
+ */
+template <typename CharT>
+using BufferTokenizer = Tokenizer<CharT, BufferInput<CharT>>;
+
+/**
+ * @brief Tokenizer that reads from a contiguous range and jumps between the
+ * token starts recorded in a `StructuralIndex` of the range
+ */
+template <typename CharT>
+using IndexedTokenizer = Tokenizer<CharT, IndexedInput<CharT>>;
+
+/**
+ * @brief Tokenizer that extracts `CompactToken`, out of a contiguous range by
+ * default
+ */
+template <typename CharT, typename InputT = BufferInput<CharT>>
+using CompactTokenizer = Tokenizer<CharT, InputT, CompactToken<CharT>>;
 }  // namespace json::token
 
 // Implementations
 
 namespace json::token {
-template <typename CharT>
-Tokenizer<CharT>::Tokenizer(InputStream &input_stream)
-    : input_stream_(input_stream) {}
+template <typename CharT, typename InputT, typename TokenT>
+Tokenizer<CharT, InputT, TokenT>::Tokenizer(InputT input,
+                                            const Options &options)
+    : input_(input), options_(options) {}
+
+template <typename CharT, typename InputT, typename TokenT>
+bool Tokenizer<CharT, InputT, TokenT>::Done() {
+  if (error_ != utils::ErrorCode::kNone) {
+    return true;
+  }
 
-template <typename CharT>
-bool Tokenizer<CharT>::Done() {
-  // can't directly use eof() method here.
-  // eof() would only return true after eof has been read.
-  // However, this method is supposed to return true when it sees eof()
-  return input_stream_.peek() == std::char_traits<CharT>::eof();
+  if constexpr (InputT::kIndexed) {
+    return input_.StructuralsDone();
+  } else {
+    return input_.Done();
+  }
 }
 
-template <typename CharT>
-void Tokenizer<CharT>::Extract() {
+template <typename CharT, typename InputT, typename TokenT>
+void Tokenizer<CharT, InputT, TokenT>::Extract() {
   using namespace json::utils;
-  using TType = typename Token<CharT>::Type;
-
-  while (!this->Done()) {
-    CharT letter = input_stream_.peek();
-    switch (letter) {
-      case ' ':
-      case '\r':
-      case '\t':
-      case '\n':
-        input_stream_.get();
+  using TType = typename TokenT::Type;
+
+  // the index points at the next token start, skipping whitespaces
+  if constexpr (InputT::kIndexed) {
+    if (!input_.SeekStructural()) {
+      token_.type = TType::kUninitialized;
+      return;
+    }
+  }
+
+  while (!input_.Done()) {
+    using char_class::Dispatch;
+
+    switch (char_class::Lookup(input_.Peek()).dispatch) {
+      case Dispatch::kWhitespace:
+        input_.Get();
         continue;
-      case '{':
+      case Dispatch::kComment:
+        if (Comment()) {
+          continue;
+        }
+
+        return;
+      case Dispatch::kBeginObject:
         token_.type = TType::kBeginObject;
-        input_stream_.get();
+        input_.Get();
         return;
-      case '}':
+      case Dispatch::kEndObject:
         token_.type = TType::kEndObject;
-        input_stream_.get();
+        input_.Get();
         return;
-      case '[':
+      case Dispatch::kBeginArray:
         token_.type = TType::kBeginArray;
-        input_stream_.get();
+        input_.Get();
         return;
-      case ']':
+      case Dispatch::kEndArray:
         token_.type = TType::kEndArray;
-        input_stream_.get();
+        input_.Get();
         return;
-      case ',':
+      case Dispatch::kValueSeparator:
         token_.type = TType::kValueSeparator;
-        input_stream_.get();
+        input_.Get();
         return;
-      case ':':
+      case Dispatch::kKeyValueSeparator:
         token_.type = TType::kKeyValueSeparator;
-        input_stream_.get();
+        input_.Get();
         return;
-      case '\"':
-        input_stream_.get();
+      case Dispatch::kString:
+        input_.Get();
         return String();
-      case '-':
-      case '0':
-      case '1':
-      case '2':
-      case '3':
-      case '4':
-      case '5':
-      case '6':
-      case '7':
-      case '8':
-      case '9':
+      case Dispatch::kNumber:
         return Number();
-      case 't':
+      case Dispatch::kTrue:
         return True();
-      case 'f':
+      case Dispatch::kFalse:
         return False();
-      case 'n':
+      case Dispatch::kNull:
         return Null();
-      default:
-        // TODO: Error handling
-        break;
+      case Dispatch::kInvalid:
+        if (options_.record_separators &&
+            input_.Peek() == letters::kRecordSeparator<CharT>) {
+          input_.Get();
+          continue;
+        }
+
+        Fail(ErrorCode::kUnexpectedLetter);
+        return;
     }
   }
+
+  // only whitespaces were left
+  token_.type = TType::kUninitialized;
 }
 
-template <typename CharT>
-void Tokenizer<CharT>::String() {
+template <typename CharT, typename InputT, typename TokenT>
+void Tokenizer<CharT, InputT, TokenT>::String() {
   enum class State {
     kRegular,
     kEscape,
-    kHex,
   };
 
   using namespace json::utils;
-  using namespace json::utils::convert;
 
-  using TType = typename Token<CharT>::Type;
+  using Status = typename EscapeDecoder<CharT>::Status;
 
-  int8_t hex_counter = 0;
-  int8_t hex_append_count = 0;
-  int32_t hex_value = 0;
+  EscapeDecoder<CharT> decoder;
   State state = State::kRegular;
-  std::basic_string<CharT> buffer;
+  std::basic_string<CharT> &buffer = buffer_;
+  // start of the letters of the buffer copied from the input since the last
+  // escape, escapes are not checked for utf8
+  size_t run = 0;
+
+  buffer.clear();
 
-  while (!this->Done()) {
-    CharT letter;
-    input_stream_.get(letter);
+  // strings without escapes reference the input instead of being copied
+  if constexpr (InputT::kContiguous) {
+    const CharT *begin = input_.cursor();
+    const CharT *stop = utils::simd::FindQuoteOrBackslash(begin, input_.end());
+
+    if (stop != input_.end() && *stop == letters::kDoubleQuote<CharT>) {
+      if (!CheckUtf8(begin, stop)) {
+        return;
+      }
+
+      if (!CheckLength(size_t(stop - begin))) {
+        return;
+      }
+
+      input_.Seek(stop + 1);
+      return token_.FormStringView({begin, size_t(stop - begin)});
+    }
+
+    buffer.append(begin, stop);
+    input_.Seek(stop);
+  }
+
+  while (!input_.Done()) {
+    // copy the run of letters up to the next quote or backslash at once
+    if constexpr (InputT::kContiguous) {
+      const CharT *begin = input_.cursor();
+      const CharT *stop =
+          utils::simd::FindQuoteOrBackslash(begin, input_.end());
+
+      buffer.append(begin, stop);
+      input_.Seek(stop);
+
+      if (input_.Done()) {
+        break;
+      }
+    }
+
+    CharT letter = input_.Get();
 
     switch (state) {
+      case State::kEscape:
+        switch (decoder.Feed(letter, buffer)) {
+          case Status::kMore:
+            continue;
+          case Status::kDone:
+            run = buffer.size();
+            state = State::kRegular;
+            continue;
+          case Status::kInvalid:
+            Fail(ErrorCode::kInvalidEscape);
+            return;
+          case Status::kDoneBefore:
+            run = buffer.size();
+            state = State::kRegular;
+            break;
+        }
+
+        // the letter after the escape is regular text
+        [[fallthrough]];
       case State::kRegular:
         switch (letter) {
           // end of string
           case '\"':
-            token_.type = TType::kString;
-            token_.data = std::move(buffer);
+            if (!CheckUtf8(buffer.data() + run,
+                           buffer.data() + buffer.size())) {
+              return;
+            }
+
+            if (CheckLength(buffer.size())) {
+              token_.FormBufferString(buffer);
+            }
+
             return;
           // start of escape sequence
           case '\\':
-            state = State::kEscape;
+            if (!CheckUtf8(buffer.data() + run,
+                           buffer.data() + buffer.size())) {
+              return;
+            }
+
+            // contiguous letters are decoded a whole sequence at once
+            if constexpr (InputT::kContiguous) {
+              const CharT *next = EscapeDecoder<CharT>::Decode(
+                  input_.cursor(), input_.end(), buffer);
+
+              if (next == nullptr) {
+                Fail(ErrorCode::kInvalidEscape);
+                return;
+              }
+
+              input_.Seek(next);
+              run = buffer.size();
+            } else {
+              state = State::kEscape;
+            }
             break;
           // regular text
           default:
@@ -173,293 +378,312 @@ void Tokenizer<CharT>::String() {
         }
 
         break;
-      case State::kEscape:
-        switch (letter) {
-          case letters::kB<CharT>:
-            state = State::kRegular;
-            buffer += letters::kBackspace<CharT>;
-            break;
-          case letters::kF<CharT>:
-            state = State::kRegular;
-            buffer += letters::kFormfeed<CharT>;
-            break;
-          case letters::kN<CharT>:
-            state = State::kRegular;
-            buffer += letters::kEndline<CharT>;
-            break;
-          case letters::kR<CharT>:
-            state = State::kRegular;
-            buffer += letters::kCarriageReturn<CharT>;
-            break;
-          case letters::kT<CharT>:
-            state = State::kRegular;
-            buffer += letters::kTab<CharT>;
-            break;
-          case letters::kSolidus<CharT>:
-            state = State::kRegular;
-            buffer += letters::kSolidus<CharT>;
-            break;
-          case letters::kBackSolidus<CharT>:
-            state = State::kRegular;
-            buffer += letters::kBackSolidus<CharT>;
-            break;
-          case letters::kDoubleQuote<CharT>:
-            state = State::kRegular;
-            buffer += letters::kDoubleQuote<CharT>;
-            break;
-          case letters::kU<CharT>:
-            state = State::kHex;
-            break;
-        }
-        break;
-      case State::kHex: {
-        ++hex_counter;
-        // stop after enough hex
-        auto current_hex_value = number::FromHex<int8_t>(letter);
+    }
+  }
 
-        // TODO:
-        // handle error if currentHexValue is -1
+  Fail(ErrorCode::kUnexpectedEnd);
+}
 
-        // utf8
-        if constexpr (sizeof(CharT) == 1) {
-          hex_value <<= 4;
-          hex_value |= current_hex_value;
+template <typename CharT, typename InputT, typename TokenT>
+void Tokenizer<CharT, InputT, TokenT>::Number() {
+  using namespace utils::convert;
 
-          ++hex_append_count;
+  number::Decimal decimal;
+  const CharT *begin;
+  const CharT *end;
+  std::basic_string<CharT> &text = buffer_;
 
-          if (hex_append_count == 2) {
-            buffer += hex_value;
+  if constexpr (InputT::kContiguous) {
+    begin = input_.cursor();
+    end = number::Scan(begin, input_.end(), decimal);
 
-            hex_value = 0;
-            hex_append_count = 0;
-          }
-        }
-        // utf16 and utf32
-        else {
-          hex_value <<= 4;
-          hex_value |= current_hex_value;
+    if (end == nullptr) {
+      Fail(utils::ErrorCode::kInvalidNumber);
+      return;
+    }
 
-          ++hex_append_count;
+    input_.Seek(end);
 
-          if (hex_append_count == 4) {
-            buffer += hex_value;
+    // keep the letters, converted when the value is read
+    if (options_.lazy_numbers) {
+      if (!CheckLength(size_t(end - begin))) {
+        return;
+      }
 
-            hex_value = 0;
-            hex_append_count = 0;
-          }
-        }
+      return token_.FormRawNumber({begin, size_t(end - begin)});
+    }
+  } else {
+    // gather the letters that can be part of a number first
+    text.clear();
 
-        if (hex_counter == 4) {
-          state = State::kRegular;
-          hex_counter = 0;
-        }
+    while (!input_.Done()) {
+      CharT letter = input_.Peek();
+
+      if (!utils::char_class::Is(letter, utils::char_class::kNumber)) {
         break;
       }
+
+      text += input_.Get();
+    }
+
+    begin = text.data();
+    end = number::Scan(begin, begin + text.size(), decimal);
+
+    // all the letters gathered must make the number
+    if (end != begin + text.size()) {
+      Fail(utils::ErrorCode::kInvalidNumber);
+      return;
     }
   }
+
+  token_.FormValue(number::Convert(decimal, begin, end));
 }
 
-template <typename CharT>
-void Tokenizer<CharT>::Number() {
-  using namespace utils::convert;
-  // Number format:
-  // -010.2e+3
-  enum class State {
-    undefined,
-    beforeDecimalPoint,
-    afterDecimalPoint,
-    afterE,
-    afterESign,
-  };
+template <typename CharT, typename InputT, typename TokenT>
+void Tokenizer<CharT, InputT, TokenT>::True() {
+  if (Literal("true")) {
+    token_.FormBoolean(true);
+  }
+}
 
-  State state = State::undefined;
-  double value = 0.0;
-  double sign = 1;
-  double postDecimalScale = 0.1;
-  double scaleSign = 1.0;
-  double scale = 0.0;
+template <typename CharT, typename InputT, typename TokenT>
+void Tokenizer<CharT, InputT, TokenT>::False() {
+  if (Literal("false")) {
+    token_.FormBoolean(false);
+  }
+}
 
-  const auto exportNumber = [&]() {
-    scale *= scaleSign;
-    return value * sign * std::pow(10, scale);
-  };
+template <typename CharT, typename InputT, typename TokenT>
+void Tokenizer<CharT, InputT, TokenT>::Null() {
+  if (Literal("null")) {
+    token_.type = TokenT::Type::kNull;
+  }
+}
 
-  while (!this->Done()) {
-    CharT letter = input_stream_.peek();
-
-    switch (letter) {
-      case ']':
-      case '}':
-      case ' ':
-      case ',':
-      case '\t':
-      case '\r':
-      case '\n':
-        return token_.FormNumber(exportNumber());
-      case '0':
-      case '1':
-      case '2':
-      case '3':
-      case '4':
-      case '5':
-      case '6':
-      case '7':
-      case '8':
-      case '9':
-        switch (state) {
-          case State::undefined:
-            value *= 10.0;
-            value += number::FromDec<double>(letter);
-            state = State::beforeDecimalPoint;
-            input_stream_.get();
-            break;
-          case State::beforeDecimalPoint:
-            value *= 10.0;
-            value += number::FromDec<double>(letter);
-            input_stream_.get();
-            break;
-          case State::afterDecimalPoint:
-            value += number::FromDec<double>(letter) * postDecimalScale;
-            postDecimalScale /= 10.0;
-            input_stream_.get();
-            break;
-          case State::afterE:
-            state = State::afterESign;
-            break;
-          case State::afterESign:
-            scale *= 10;
-            scale += number::FromDec<double>(letter);
-            input_stream_.get();
-            break;
-          default:
-            input_stream_.get();
-            break;
-        }
-        break;
-      case 'e':
-      case 'E':
-        switch (state) {
-          case State::undefined:
-          case State::beforeDecimalPoint:
-          case State::afterDecimalPoint:
-            state = State::afterE;
-            break;
-          default:
-            break;
-        }
+template <typename CharT, typename InputT, typename TokenT>
+template <size_t kSize>
+bool Tokenizer<CharT, InputT, TokenT>::Literal(
+    const char (&letters)[kSize]) {
+  using namespace utils;
 
-        input_stream_.get(letter);
-        break;
-      case '.':
-        switch (state) {
-          case State::undefined:
-          case State::beforeDecimalPoint:
-            state = State::afterDecimalPoint;
-            break;
-          default:
-            break;
-        }
+  constexpr size_t kLength = kSize - 1;
+  static_assert(kLength >= 4, "literals have at least 4 letters");
 
-        input_stream_.get(letter);
-        break;
-      case '-':
-        switch (state) {
-          case State::undefined:
-            sign = -1;
-            state = State::beforeDecimalPoint;
-            break;
-          case State::afterE:
-            scaleSign = -1;
-            state = State::afterESign;
-            break;
-          default:
-            break;
+  if constexpr (InputT::kContiguous) {
+    const CharT *cursor = input_.cursor();
+
+    if (size_t(input_.end() - cursor) < kLength) {
+      return Fail(ErrorCode::kUnexpectedEnd);
+    }
+
+    if constexpr (sizeof(CharT) == 1) {
+      // the first letter is known from the dispatch, compare the last 4
+      // letters with a single load, which covers all of `true` and `null`
+      uint32_t word;
+      uint32_t expected;
+      std::memcpy(&word, cursor + kLength - 4, 4);
+      std::memcpy(&expected, letters + kLength - 4, 4);
+
+      if (word != expected) {
+        return Fail(ErrorCode::kInvalidLiteral);
+      }
+    } else {
+      for (size_t i = 1; i < kLength; ++i) {
+        if (cursor[i] != CharT(letters[i])) {
+          return Fail(ErrorCode::kInvalidLiteral);
         }
-        input_stream_.get();
-        break;
-      default:
-        break;
+      }
+    }
+
+    input_.Seek(cursor + kLength);
+  } else {
+    for (size_t i = 0; i < kLength; ++i) {
+      if (input_.Done()) {
+        return Fail(ErrorCode::kUnexpectedEnd);
+      }
+
+      if (input_.Get() != CharT(letters[i])) {
+        return Fail(ErrorCode::kInvalidLiteral);
+      }
+    }
+  }
+
+  // `truex` or `null1` are not literals
+  if (!input_.Done()) {
+    constexpr uint8_t kDelimiter =
+        char_class::kWhitespace | char_class::kStructural;
+
+    CharT next = input_.Peek();
+    bool delimiter =
+        char_class::Is(next, kDelimiter) ||
+        (options_.comments && next == letters::kSolidus<CharT>) ||
+        (options_.record_separators &&
+         next == letters::kRecordSeparator<CharT>);
+
+    if (!delimiter) {
+      return Fail(ErrorCode::kInvalidLiteral);
     }
   }
 
-  token_.FormNumber(exportNumber());
+  return true;
 }
 
-template <typename CharT>
-void Tokenizer<CharT>::True() {
-  const char letters[] = {'t', 'r', 'u', 'e'};
-  int i = 0;
+template <typename CharT, typename InputT, typename TokenT>
+bool Tokenizer<CharT, InputT, TokenT>::Comment() {
+  using namespace utils;
+  using Traits = std::char_traits<CharT>;
+
+  if (!options_.comments) {
+    return Fail(ErrorCode::kUnexpectedLetter);
+  }
+
+  input_.Get();
+
+  if (input_.Done()) {
+    return Fail(ErrorCode::kUnexpectedEnd);
+  }
 
-  while (!this->Done()) {
-    CharT letter = input_stream_.peek();
+  CharT kind = input_.Get();
+  bool line = kind == letters::kSolidus<CharT>;
 
-    if (letter != static_cast<CharT>(letters[i])) {
-      // TODO: Error handling
+  if (!line && kind != CharT('*')) {
+    return Fail(ErrorCode::kUnexpectedLetter);
+  }
+
+  if constexpr (InputT::kContiguous) {
+    // search the end of the comment without copying it
+    const CharT *begin = input_.cursor();
+    const CharT *end = input_.end();
+    const CharT *stop;
+
+    if (line) {
+      stop = Traits::find(begin, size_t(end - begin), letters::kEndline<CharT>);
+      stop = stop == nullptr ? end : stop;
+      input_.Seek(stop);
+    } else {
+      for (stop = begin;; ++stop) {
+        stop = Traits::find(stop, size_t(end - stop), CharT('*'));
+
+        if (stop == nullptr || end - stop < 2) {
+          return Fail(ErrorCode::kUnexpectedEnd);
+        }
+
+        if (stop[1] == letters::kSolidus<CharT>) {
+          break;
+        }
+      }
+
+      input_.Seek(stop + 2);
     }
 
-    if (i == 3) {
-      input_stream_.get(letter);
-      return token_.FormBoolean(true);
+    if (options_.comment_tokens) {
+      if (CheckLength(size_t(stop - begin))) {
+        token_.FormCommentView({begin, size_t(stop - begin)});
+      }
+
+      return false;
     }
+  } else {
+    // the text is only kept when comment tokens are asked for
+    bool keep = options_.comment_tokens;
+    std::basic_string<CharT> &text = buffer_;
 
-    ++i;
-    input_stream_.get(letter);
-  }
+    text.clear();
 
-  // TODO: Error handling
-}
+    if (line) {
+      while (!input_.Done() && input_.Peek() != letters::kEndline<CharT>) {
+        CharT letter = input_.Get();
 
-template <typename CharT>
-void Tokenizer<CharT>::False() {
-  const char letters[] = {'f', 'a', 'l', 's', 'e'};
-  int i = 0;
+        if (keep) {
+          text += letter;
+        }
+      }
+    } else {
+      CharT previous = 0;
+
+      while (true) {
+        if (input_.Done()) {
+          return Fail(ErrorCode::kUnexpectedEnd);
+        }
+
+        CharT letter = input_.Get();
+
+        if (previous == CharT('*') && letter == letters::kSolidus<CharT>) {
+          break;
+        }
+
+        if (keep) {
+          text += letter;
+        }
 
-  while (!this->Done()) {
-    CharT letter = input_stream_.peek();
+        previous = letter;
+      }
 
-    if (letter != static_cast<CharT>(letters[i])) {
-      // TODO: Error handling
+      // the `*` of the end marker has been kept
+      if (keep) {
+        text.pop_back();
+      }
     }
 
-    if (i == 4) {
-      input_stream_.get(letter);
-      return token_.FormBoolean(false);
+    if (keep) {
+      if (CheckLength(text.size())) {
+        token_.FormBufferComment(text);
+      }
+
+      return false;
     }
+  }
 
-    ++i;
-    input_stream_.get(letter);
+  return true;
+}
+
+template <typename CharT, typename InputT, typename TokenT>
+bool Tokenizer<CharT, InputT, TokenT>::CheckUtf8(const CharT *begin,
+                                         const CharT *end) {
+  if constexpr (sizeof(CharT) == 1) {
+    if (options_.validate_utf8 &&
+        !utils::utf8::Validate(reinterpret_cast<const char *>(begin),
+                               reinterpret_cast<const char *>(end))) {
+      return Fail(utils::ErrorCode::kInvalidUtf8);
+    }
   }
 
-  // TODO: Error handling
+  return true;
 }
 
-template <typename CharT>
-void Tokenizer<CharT>::Null() {
-  const char letters[] = {'n', 'u', 'l', 'l'};
-  int i = 0;
+template <typename CharT, typename InputT, typename TokenT>
+bool Tokenizer<CharT, InputT, TokenT>::CheckLength(size_t length) {
+  if (length > TokenT::kMaxLength) {
+    return Fail(utils::ErrorCode::kTooLarge);
+  }
 
-  while (!this->Done()) {
-    CharT letter = input_stream_.peek();
+  return true;
+}
 
-    if (letter != static_cast<CharT>(letters[i])) {
-      // TODO: Error handling
-    }
+template <typename CharT, typename InputT, typename TokenT>
+bool Tokenizer<CharT, InputT, TokenT>::Fail(utils::ErrorCode error) {
+  error_ = error;
+  token_.type = TokenT::Type::kUninitialized;
 
-    if (i == 3) {
-      token_.type = Token<CharT>::Type::kNull;
-      input_stream_.get(letter);
-      return;
-    }
+  return false;
+}
 
-    ++i;
-    input_stream_.get(letter);
-  }
+template <typename CharT, typename InputT, typename TokenT>
+utils::ErrorCode Tokenizer<CharT, InputT, TokenT>::error() const {
+  return error_;
+}
 
-  // TODO: Error handling
+template <typename CharT, typename InputT, typename TokenT>
+size_t Tokenizer<CharT, InputT, TokenT>::offset() {
+  if constexpr (InputT::kContiguous) {
+    return size_t(input_.cursor() - input_.begin());
+  } else {
+    return input_.offset();
+  }
 }
 
-template <typename CharT>
-Token<CharT> &Tokenizer<CharT>::token() {
+template <typename CharT, typename InputT, typename TokenT>
+TokenT &Tokenizer<CharT, InputT, TokenT>::token() {
   return token_;
 }
 }  // namespace json::token
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include "json/token/compact_token.h"
+#include "json/utils/convert.h"
+#include "json/utils/transcode.h"
+
+namespace json::token {
+/**
+ * @brief Token of a utf8 text whose letters are read as utf16 or utf32
+ *
+ * The tokens of the text are extracted as `CompactToken<char>`, only the
+ * letters of strings are transcoded, into a buffer that is reused from one
+ * token to the next. Raw numbers are not supported, the letters of a lazy
+ * number would have to outlive the token.
+ */
+template <typename CharT>
+class TranscodedToken {
+ public:
+  using Source = CompactToken<char>;
+  using Type = typename Source::Type;
+  using StringViewData = std::basic_string_view<CharT>;
+
+  /**
+   * Become a copy of a token of the text, transcoding its letters
+   * @param source the token of the text
+   */
+  void Assign(const Source &source);
+
+  /**
+   * Get the transcoded letters if the type is string or comment
+   * @returns a view of the letters
+   */
+  StringViewData string() const;
+
+  /**
+   * See if the number is the letters of the number
+   * @returns `false`, raw numbers are not supported
+   */
+  bool IsRawNumber() const;
+
+  /**
+   * Get the value of the number
+   * @returns the value of the number
+   */
+  utils::convert::number::Value NumberValue() const;
+
+  /**
+   * Get the boolean
+   * @returns the boolean
+   */
+  bool boolean() const;
+
+  /**
+   * Type of the token
+   */
+  Type type = Type::kUninitialized;
+
+ private:
+  Source source_;
+  std::basic_string<CharT> buffer_;
+};
+}  // namespace json::token
+
+// Implementations
+
+namespace json::token {
+template <typename CharT>
+void TranscodedToken<CharT>::Assign(const Source &source) {
+  type = source.type;
+  source_ = source;
+
+  if (type == Type::kString || type == Type::kComment) {
+    std::string_view letters = source.string();
+
+    buffer_.clear();
+    utils::transcode::Transcode(letters.data(),
+                                letters.data() + letters.size(), buffer_);
+  }
+}
+
+template <typename CharT>
+typename TranscodedToken<CharT>::StringViewData
+TranscodedToken<CharT>::string() const {
+  return buffer_;
+}
+
+template <typename CharT>
+bool TranscodedToken<CharT>::IsRawNumber() const {
+  return false;
+}
+
+template <typename CharT>
+utils::convert::number::Value TranscodedToken<CharT>::NumberValue() const {
+  return source_.NumberValue();
+}
+
+template <typename CharT>
+bool TranscodedToken<CharT>::boolean() const {
+  return source_.boolean();
+}
+}  // namespace json::token
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+namespace json::utils {
+/**
+ * @brief Queue shared by threads that holds a limited number of items,
+ * producers wait while it is full and consumers wait while it is empty
+ */
+template <typename T>
+class BoundedQueue {
+ public:
+  /**
+   * @brief Create an empty queue
+   * @param capacity the number of items held before `Push` waits, at least 1
+   */
+  explicit BoundedQueue(size_t capacity);
+
+  BoundedQueue(const BoundedQueue &) = delete;
+  BoundedQueue &operator=(const BoundedQueue &) = delete;
+
+  /**
+   * @brief Add an item, waiting for room if the queue is full
+   * @param item the item to add
+   * @returns `false` if the queue is closed, the item is then dropped
+   */
+  bool Push(T &&item);
+
+  /**
+   * @brief Remove the oldest item, waiting for one if the queue is empty
+   * @returns the item, or nothing once the queue is closed and empty
+   */
+  std::optional<T> Pop();
+
+  /**
+   * @brief Stop accepting items, the items left can still be popped
+   */
+  void Close();
+
+ private:
+  std::deque<T> items_;
+  size_t capacity_;
+  bool closed_ = false;
+  std::mutex mutex_;
+  std::condition_variable not_full_;
+  std::condition_variable not_empty_;
+};
+}  // namespace json::utils
+
+// Implementations
+
+namespace json::utils {
+template <typename T>
+BoundedQueue<T>::BoundedQueue(size_t capacity)
+    : capacity_{std::max<size_t>(capacity, 1)} {}
+
+template <typename T>
+bool BoundedQueue<T>::Push(T &&item) {
+  {
+    std::unique_lock<std::mutex> lock{mutex_};
+    not_full_.wait(lock,
+                   [this]() { return closed_ || items_.size() < capacity_; });
+
+    if (closed_) {
+      return false;
+    }
+
+    items_.push_back(std::move(item));
+  }
+
+  not_empty_.notify_one();
+  return true;
+}
+
+template <typename T>
+std::optional<T> BoundedQueue<T>::Pop() {
+  std::optional<T> item;
+
+  {
+    std::unique_lock<std::mutex> lock{mutex_};
+    not_empty_.wait(lock, [this]() { return closed_ || !items_.empty(); });
+
+    if (items_.empty()) {
+      return item;
+    }
+
+    item.emplace(std::move(items_.front()));
+    items_.pop_front();
+  }
+
+  not_full_.notify_one();
+  return item;
+}
+
+template <typename T>
+void BoundedQueue<T>::Close() {
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    closed_ = true;
+  }
+
+  not_full_.notify_all();
+  not_empty_.notify_all();
+}
+}  // namespace json::utils
@@ -0,0 +1,185 @@
+#pragma once
+
+#include <stdint.h>
+#include <array>
+#include "json/utils/letters.h"
+
+namespace json::utils::char_class {
+/**
+ * @brief Classes a letter can belong to, combined as bit flags
+ */
+enum Class : uint8_t {
+  kWhitespace = 1 << 0,
+  kStructural = 1 << 1,
+  kDigit = 1 << 2,
+  kHexDigit = 1 << 3,
+  /**
+   * @brief Letters that can follow a backslash in a string
+   */
+  kEscape = 1 << 4,
+  /**
+   * @brief Letters that can be part of a number
+   */
+  kNumber = 1 << 5,
+};
+
+/**
+ * @brief What the tokenizer does with a letter found outside of a string
+ */
+enum class Dispatch : uint8_t {
+  kInvalid,
+  kWhitespace,
+  kBeginObject,
+  kEndObject,
+  kBeginArray,
+  kEndArray,
+  kValueSeparator,
+  kKeyValueSeparator,
+  kString,
+  kNumber,
+  kTrue,
+  kFalse,
+  kNull,
+  kComment,
+};
+
+/**
+ * @brief Everything known about a letter
+ */
+struct Entry {
+  uint8_t classes = 0;
+  Dispatch dispatch = Dispatch::kInvalid;
+  /**
+   * @brief Value of a hex digit, -1 for other letters
+   */
+  int8_t value = -1;
+  /**
+   * @brief Letter produced when the letter follows a backslash, 0 when the
+   * letter is not a single letter escape
+   */
+  char escaped = 0;
+};
+
+/**
+ * @brief Table of the 256 byte values
+ */
+using Table = std::array<Entry, 256>;
+
+/**
+ * @brief Build the table at compile time
+ */
+constexpr Table BuildTable();
+
+/**
+ * @brief Look up a letter, letters wider than a byte outside of the ascii
+ * range all share the entry of a letter without class
+ * @param letter the letter to look up
+ * @returns the entry of the letter
+ */
+template <typename CharT>
+constexpr const Entry &Lookup(CharT letter);
+
+/**
+ * @brief Determine if a letter belongs to some classes
+ * @param letter the letter
+ * @param classes the classes, combined as bit flags
+ * @returns `true` if the letter belongs to any of the classes
+ */
+template <typename CharT>
+constexpr bool Is(CharT letter, uint8_t classes);
+}  // namespace json::utils::char_class
+
+// Implementations
+
+namespace json::utils::char_class {
+constexpr Table BuildTable() {
+  using namespace json::utils::letters;
+
+  Table table{};
+
+  for (char letter : {kSpace<char>, kTab<char>, kCarriageReturn<char>,
+                      kEndline<char>}) {
+    table[uint8_t(letter)].classes |= kWhitespace;
+    table[uint8_t(letter)].dispatch = Dispatch::kWhitespace;
+  }
+
+  for (char letter : {kLeftCurleyBrace<char>, kRightCurleyBrace<char>,
+                      kLeftSquareBracket<char>, kRightSquareBracket<char>,
+                      kComma<char>, kColon<char>}) {
+    table[uint8_t(letter)].classes |= kStructural;
+  }
+
+  table[uint8_t(kLeftCurleyBrace<char>)].dispatch = Dispatch::kBeginObject;
+  table[uint8_t(kRightCurleyBrace<char>)].dispatch = Dispatch::kEndObject;
+  table[uint8_t(kLeftSquareBracket<char>)].dispatch = Dispatch::kBeginArray;
+  table[uint8_t(kRightSquareBracket<char>)].dispatch = Dispatch::kEndArray;
+  table[uint8_t(kComma<char>)].dispatch = Dispatch::kValueSeparator;
+  table[uint8_t(kColon<char>)].dispatch = Dispatch::kKeyValueSeparator;
+  table[uint8_t(kDoubleQuote<char>)].dispatch = Dispatch::kString;
+  table[uint8_t(kT<char>)].dispatch = Dispatch::kTrue;
+  table[uint8_t(kF<char>)].dispatch = Dispatch::kFalse;
+  table[uint8_t(kN<char>)].dispatch = Dispatch::kNull;
+  table[uint8_t(kSolidus<char>)].dispatch = Dispatch::kComment;
+
+  for (int i = 0; i < 10; ++i) {
+    Entry &entry = table['0' + i];
+    entry.classes |= kDigit | kHexDigit | kNumber;
+    entry.dispatch = Dispatch::kNumber;
+    entry.value = int8_t(i);
+  }
+
+  for (int i = 0; i < 6; ++i) {
+    table['a' + i].classes |= kHexDigit;
+    table['a' + i].value = int8_t(10 + i);
+    table['A' + i].classes |= kHexDigit;
+    table['A' + i].value = int8_t(10 + i);
+  }
+
+  for (char letter : {'-', '+', '.', 'e', 'E'}) {
+    table[uint8_t(letter)].classes |= kNumber;
+  }
+
+  table['-'].dispatch = Dispatch::kNumber;
+
+  // single letter escapes, `u` starts a hex escape instead
+  const char escapes[][2] = {
+      {kB<char>, kBackspace<char>},
+      {kF<char>, kFormfeed<char>},
+      {kN<char>, kEndline<char>},
+      {kR<char>, kCarriageReturn<char>},
+      {kT<char>, kTab<char>},
+      {kSolidus<char>, kSolidus<char>},
+      {kBackSolidus<char>, kBackSolidus<char>},
+      {kDoubleQuote<char>, kDoubleQuote<char>},
+  };
+
+  for (const auto &escape : escapes) {
+    table[uint8_t(escape[0])].classes |= kEscape;
+    table[uint8_t(escape[0])].escaped = escape[1];
+  }
+
+  table[uint8_t(kU<char>)].classes |= kEscape;
+
+  return table;
+}
+
+/**
+ * @brief The table, letters outside of the ascii range have no class
+ */
+inline constexpr Table kTable = BuildTable();
+
+template <typename CharT>
+constexpr const Entry &Lookup(CharT letter) {
+  if constexpr (sizeof(CharT) == 1) {
+    return kTable[uint8_t(letter)];
+  } else {
+    // 0x80 is not ascii and has no class
+    return kTable[uint32_t(letter) < 0x80 ? uint32_t(letter) : 0x80];
+  }
+}
+
+template <typename CharT>
+constexpr bool Is(CharT letter, uint8_t classes) {
+  return (Lookup(letter).classes & classes) != 0;
+}
+}  // namespace json::utils::char_class
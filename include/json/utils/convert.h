@@ -1,13 +1,126 @@
 #pragma once
 
 #include <stdint.h>
+#include <charconv>
+#include <cstddef>
+#include <limits>
+#include <locale>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <variant>
+#include "json/utils/char_class.h"
 
 namespace json::utils::convert::number {
+/**
+ * @brief Get the value of a hex digit
+ * @returns the value, -1 if the letter is not a hex digit
+ */
 template <typename IntT, typename CharT>
 IntT FromHex(CharT letter);
 
+/**
+ * @brief Get the value of a decimal digit
+ * @returns the value, -1 if the letter is not a decimal digit
+ */
 template <typename IntT, typename CharT>
 IntT FromDec(CharT letter);
+
+/**
+ * @brief A decimal number split into its parts, value is
+ * `(-1)^negative * mantissa * 10^exponent`
+ */
+struct Decimal {
+  bool negative = false;
+  uint64_t mantissa = 0;
+  int32_t exponent = 0;
+
+  /**
+   * @brief `false` if some digits did not fit in the mantissa
+   */
+  bool exact = true;
+
+  /**
+   * @brief `false` if the number has a fraction or an exponent
+   */
+  bool integer = true;
+
+  /**
+   * @brief Append a digit to the mantissa
+   * @param digit the value of the digit
+   * @returns `false` if the digit did not fit in the mantissa
+   */
+  bool PushDigit(uint64_t digit);
+};
+
+/**
+ * @brief Value of a json number, integers that fit in 64 bits keep their
+ * exact value
+ */
+using Value = std::variant<double, int64_t, uint64_t>;
+
+/**
+ * @brief Scan the letters of a json number into a decimal
+ * @param begin pointer to the first letter of the number
+ * @param end pointer past the last letter available
+ * @param decimal the decimal to fill
+ * @returns pointer past the last letter of the number, `nullptr` if the
+ * letters do not start with a json number
+ */
+template <typename CharT>
+const CharT *Scan(const CharT *begin, const CharT *end, Decimal &decimal);
+
+/**
+ * @brief Convert a scanned number to its value
+ * @param decimal the decimal filled by `Scan`
+ * @param begin pointer to the first letter of the number
+ * @param end pointer past the last letter of the number
+ * @returns the value of the number
+ */
+template <typename CharT>
+Value Convert(const Decimal &decimal, const CharT *begin, const CharT *end);
+
+/**
+ * @brief Scan and convert the letters of a json number
+ * @param begin pointer to the first letter of the number
+ * @param end pointer past the last letter of the number
+ * @returns the value of the number, 0 if the letters are not a json number
+ */
+template <typename CharT>
+Value Parse(const CharT *begin, const CharT *end);
+
+/**
+ * @brief Convert a decimal to a double when the result can be computed
+ * exactly with a single floating point operation
+ * @param decimal the decimal to convert
+ * @param value set to the correctly rounded value on success
+ * @returns `true` on success, `false` if the slow path must be used
+ */
+bool FastToDouble(const Decimal &decimal, double &value);
+
+/**
+ * @brief Get the value of a number too large or too small for a double
+ * @returns infinity if the number overflows, zero if it underflows
+ */
+double OutOfRange(const char *begin, const char *end);
+
+/**
+ * @brief Convert the text of a json number to the correctly rounded double
+ * @param begin pointer to the first letter of the number
+ * @param end pointer past the last letter of the number
+ * @returns the value of the number
+ */
+template <typename CharT>
+double ToDouble(const CharT *begin, const CharT *end);
+
+/**
+ * @brief Convert a number to a 64 bit integer, clamping it to the limits of
+ * the integer
+ * @param value a double, which is truncated, or a 64 bit integer
+ * @returns the integer, 0 if the value is not a number
+ */
+template <typename IntT, typename T>
+IntT ToInteger(T value);
 }  // namespace json::utils::convert::number
 
 // Implementations
@@ -15,53 +128,273 @@ IntT FromDec(CharT letter);
 namespace json::utils::convert::number {
 template <typename IntT, typename CharT>
 IntT FromHex(CharT letter) {
-  switch (letter) {
-    case '0':
-    case '1':
-    case '2':
-    case '3':
-    case '4':
-    case '5':
-    case '6':
-    case '7':
-    case '8':
-    case '9':
-      return letter - 48;
-    case 'a':
-    case 'b':
-    case 'c':
-    case 'd':
-    case 'e':
-    case 'f':
-      return letter - 87;
-    case 'A':
-    case 'B':
-    case 'C':
-    case 'D':
-    case 'E':
-    case 'F':
-      return letter - 55;
-    default:
-      return -1;
-  }
+  return IntT(char_class::Lookup(letter).value);
 }
 
 template <typename IntT, typename CharT>
 IntT FromDec(CharT letter) {
-  switch (letter) {
-    case '0':
-    case '1':
-    case '2':
-    case '3':
-    case '4':
-    case '5':
-    case '6':
-    case '7':
-    case '8':
-    case '9':
-      return letter - 48;
-    default:
-      return -1;
+  const char_class::Entry &entry = char_class::Lookup(letter);
+
+  return (entry.classes & char_class::kDigit) != 0 ? IntT(entry.value)
+                                                   : IntT(-1);
+}
+
+inline bool Decimal::PushDigit(uint64_t digit) {
+  constexpr uint64_t kMax = ~uint64_t{0};
+
+  if (mantissa > kMax / 10 || (mantissa == kMax / 10 && digit > kMax % 10)) {
+    exact = false;
+    return false;
+  }
+
+  mantissa = mantissa * 10 + digit;
+  return true;
+}
+
+inline bool FastToDouble(const Decimal &decimal, double &value) {
+  static constexpr double kPowers[] = {
+      1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+      1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+  };
+
+  // both the mantissa and the power of 10 are exact doubles, so the single
+  // multiplication or division is correctly rounded
+  if (!decimal.exact || decimal.mantissa > (uint64_t{1} << 53) ||
+      decimal.exponent < -22 || decimal.exponent > 22) {
+    return false;
+  }
+
+  value = double(decimal.mantissa);
+
+  if (decimal.exponent < 0) {
+    value /= kPowers[-decimal.exponent];
+  } else {
+    value *= kPowers[decimal.exponent];
+  }
+
+  if (decimal.negative) {
+    value = -value;
+  }
+
+  return true;
+}
+
+inline double OutOfRange(const char *begin, const char *end) {
+  bool negative = *begin == '-';
+  bool leading = true;
+  bool after_point = false;
+  int64_t magnitude = 0;
+
+  // magnitude is the position of the first significant digit relative to
+  // the decimal point, before applying the exponent
+  for (; begin != end && *begin != 'e' && *begin != 'E'; ++begin) {
+    if (*begin == '.') {
+      after_point = true;
+    } else if (*begin >= '0' && *begin <= '9') {
+      if (leading && *begin == '0') {
+        magnitude -= after_point ? 1 : 0;
+        continue;
+      }
+
+      leading = false;
+      magnitude += after_point ? 0 : 1;
+    }
+  }
+
+  if (begin != end) {
+    ++begin;
+
+    int64_t exponent = 0;
+    bool negative_exponent = *begin == '-';
+
+    for (; begin != end; ++begin) {
+      if (*begin >= '0' && *begin <= '9' && exponent < 100000000) {
+        exponent = exponent * 10 + (*begin - '0');
+      }
+    }
+
+    magnitude += negative_exponent ? -exponent : exponent;
+  }
+
+  double value = magnitude > 0 ? std::numeric_limits<double>::infinity() : 0.0;
+
+  return negative ? -value : value;
+}
+
+template <typename CharT>
+double ToDouble(const CharT *begin, const CharT *end) {
+  double value = 0.0;
+
+  if constexpr (sizeof(CharT) == 1) {
+    const char *first = reinterpret_cast<const char *>(begin);
+    const char *last = reinterpret_cast<const char *>(end);
+
+#if defined(__cpp_lib_to_chars)
+    auto result = std::from_chars(first, last, value);
+
+    if (result.ec == std::errc::result_out_of_range) {
+      value = OutOfRange(first, last);
+    }
+#else
+    std::istringstream stream{std::string(first, last)};
+    stream.imbue(std::locale::classic());
+    stream >> value;
+#endif
+  } else {
+    // numbers are made of ascii letters only
+    std::string narrow(begin, end);
+    value = ToDouble(narrow.data(), narrow.data() + narrow.size());
   }
+
+  return value;
+}
+
+template <typename CharT>
+const CharT *Scan(const CharT *begin, const CharT *end, Decimal &decimal) {
+  // Number format:
+  // -10.2e+3
+  const CharT *cursor = begin;
+  int32_t exponent = 0;
+  bool negative_exponent = false;
+
+  const auto digit = [&]() -> int {
+    return cursor == end ? -1 : FromDec<int>(*cursor);
+  };
+
+  if (cursor != end && *cursor == '-') {
+    decimal.negative = true;
+    ++cursor;
+  }
+
+  // the integer part is either 0 or does not start with 0
+  if (digit() == 0) {
+    ++cursor;
+
+    if (digit() >= 0) {
+      return nullptr;
+    }
+  } else if (digit() < 0) {
+    return nullptr;
+  }
+
+  for (int value = digit(); value >= 0; ++cursor, value = digit()) {
+    // digits that do not fit still scale the value
+    if (!decimal.PushDigit(value)) {
+      ++decimal.exponent;
+    }
+  }
+
+  if (cursor != end && *cursor == '.') {
+    decimal.integer = false;
+    ++cursor;
+
+    if (digit() < 0) {
+      return nullptr;
+    }
+
+    for (int value = digit(); value >= 0; ++cursor, value = digit()) {
+      if (decimal.PushDigit(value)) {
+        --decimal.exponent;
+      }
+    }
+  }
+
+  if (cursor != end && (*cursor == 'e' || *cursor == 'E')) {
+    decimal.integer = false;
+    ++cursor;
+
+    if (cursor != end && (*cursor == '-' || *cursor == '+')) {
+      negative_exponent = *cursor == '-';
+      ++cursor;
+    }
+
+    if (digit() < 0) {
+      return nullptr;
+    }
+
+    for (int value = digit(); value >= 0; ++cursor, value = digit()) {
+      // larger exponents all overflow or underflow anyway
+      if (exponent < 100000) {
+        exponent = exponent * 10 + value;
+      }
+    }
+  }
+
+  decimal.exponent += negative_exponent ? -exponent : exponent;
+
+  return cursor;
+}
+
+template <typename CharT>
+Value Convert(const Decimal &decimal, const CharT *begin, const CharT *end) {
+  // integers that fit in 64 bits keep their exact value, -0 stays a double
+  if (decimal.integer && decimal.exact &&
+      (decimal.mantissa != 0 || !decimal.negative)) {
+    constexpr uint64_t kMaxInteger = uint64_t{INT64_MAX};
+
+    if (!decimal.negative && decimal.mantissa > kMaxInteger) {
+      return decimal.mantissa;
+    }
+
+    if (decimal.mantissa <= kMaxInteger + 1) {
+      // negate in unsigned arithmetic, INT64_MIN has no positive counterpart
+      return int64_t(decimal.negative ? 0 - decimal.mantissa
+                                      : decimal.mantissa);
+    }
+  }
+
+  double result;
+
+  if (!FastToDouble(decimal, result)) {
+    result = ToDouble(begin, end);
+  }
+
+  return result;
 }
-}  // namespace json::utils::convert::number
\ No newline at end of file
+
+template <typename IntT, typename T>
+IntT ToInteger(T value) {
+  using Limits = std::numeric_limits<IntT>;
+
+  static_assert(sizeof(IntT) == 8, "only 64 bit integers are supported");
+
+  if constexpr (std::is_floating_point_v<T>) {
+    // the limits are powers of 2, or one less, so the bounds are exact:
+    // -2^63 and 0 below, 2^63 and 2^64 above
+    constexpr T kLower = T(Limits::min());
+    constexpr T kUpper = T(Limits::max() / 2 + 1) * 2;
+
+    if (value != value) {
+      return 0;
+    }
+
+    if (value <= kLower) {
+      return Limits::min();
+    }
+
+    if (value >= kUpper) {
+      return Limits::max();
+    }
+
+    return IntT(value);
+  } else if constexpr (std::is_signed_v<T> && !std::is_signed_v<IntT>) {
+    return value < 0 ? IntT{0} : IntT(value);
+  } else if constexpr (!std::is_signed_v<T> && std::is_signed_v<IntT>) {
+    return value > T(Limits::max()) ? Limits::max() : IntT(value);
+  } else {
+    return IntT(value);
+  }
+}
+
+template <typename CharT>
+Value Parse(const CharT *begin, const CharT *end) {
+  Decimal decimal;
+  end = Scan(begin, end, decimal);
+
+  if (end == nullptr) {
+    return Value{};
+  }
+
+  return Convert(decimal, begin, end);
+}
+}  // namespace json::utils::convert::number
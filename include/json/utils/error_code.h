@@ -0,0 +1,83 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace json::utils {
+/**
+ * @brief Reasons a json text can be rejected for
+ */
+enum class ErrorCode : uint8_t {
+  kNone,
+  /**
+   * @brief A letter that cannot start a token
+   */
+  kUnexpectedLetter,
+  /**
+   * @brief A letter starting with `t`, `f` or `n` is not `true`, `false` or
+   * `null` followed by a delimiter
+   */
+  kInvalidLiteral,
+  /**
+   * @brief The input ended in the middle of a token
+   */
+  kUnexpectedEnd,
+  /**
+   * @brief A string is not well formed utf8
+   */
+  kInvalidUtf8,
+  /**
+   * @brief A backslash in a string is not followed by a valid escape
+   */
+  kInvalidEscape,
+  /**
+   * @brief A token that is not allowed where it appears, or trailing tokens
+   * after the value
+   */
+  kUnexpectedToken,
+  /**
+   * @brief A number is not well formed, such as `01`, `1.` or `-`
+   */
+  kInvalidNumber,
+  /**
+   * @brief The text or a string is larger than what can be recorded with 32
+   * bit offsets and lengths
+   */
+  kTooLarge,
+};
+
+/**
+ * @brief Describe an error code
+ * @param code the error code
+ * @returns a short description of the error
+ */
+const char *Describe(ErrorCode code);
+}  // namespace json::utils
+
+// Implementations
+
+namespace json::utils {
+inline const char *Describe(ErrorCode code) {
+  switch (code) {
+    case ErrorCode::kNone:
+      return "no error";
+    case ErrorCode::kUnexpectedLetter:
+      return "unexpected letter";
+    case ErrorCode::kInvalidLiteral:
+      return "invalid literal";
+    case ErrorCode::kUnexpectedEnd:
+      return "unexpected end of input";
+    case ErrorCode::kInvalidUtf8:
+      return "invalid utf8";
+    case ErrorCode::kInvalidEscape:
+      return "invalid escape sequence";
+    case ErrorCode::kUnexpectedToken:
+      return "unexpected token";
+    case ErrorCode::kInvalidNumber:
+      return "invalid number";
+    case ErrorCode::kTooLarge:
+      return "input too large";
+  }
+
+  return "unknown error";
+}
+}  // namespace json::utils
@@ -39,6 +39,9 @@ inline constexpr CharT kTab{'\t'};
 template <typename CharT>
 inline constexpr CharT kFormfeed{'\f'};
 
+template <typename CharT>
+inline constexpr CharT kRecordSeparator{'\x1e'};
+
 template <typename CharT>
 inline constexpr CharT kBackspace{'\b'};
 
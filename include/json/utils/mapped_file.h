@@ -0,0 +1,145 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// Files are mapped with mmap where it is available, other platforms read the
+// whole file into memory instead
+#if defined(__unix__) || defined(__APPLE__)
+#define JSON_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#include <iterator>
+#endif
+
+namespace json::utils {
+/**
+ * @brief Read-only view of the content of a file, mapped into memory
+ *
+ * The pages are read by the kernel as they are touched, and the mapping is
+ * advised to be read sequentially so that the kernel reads ahead.
+ */
+class MappedFile {
+ public:
+  /**
+   * @brief Map a file
+   * @param path path to the file, check `is_open()` for success
+   */
+  explicit MappedFile(const char *path);
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  /**
+   * @brief Unmap the file
+   */
+  ~MappedFile();
+
+  /**
+   * @brief Determine if the file has been mapped
+   * @returns `true` if the file could be opened and mapped
+   */
+  bool is_open() const;
+
+  /**
+   * @brief Pointer to the first byte of the file
+   */
+  const char *begin() const;
+
+  /**
+   * @brief Pointer past the last byte of the file
+   */
+  const char *end() const;
+
+  /**
+   * @brief Number of bytes in the file
+   */
+  size_t size() const;
+
+ private:
+  const char *data_ = nullptr;
+  size_t size_ = 0;
+  bool open_ = false;
+#ifndef JSON_MMAP
+  std::string content_;
+#endif
+};
+}  // namespace json::utils
+
+// Implementations
+
+namespace json::utils {
+inline MappedFile::MappedFile(const char *path) {
+#ifdef JSON_MMAP
+  int fd = ::open(path, O_RDONLY);
+
+  if (fd < 0) {
+    return;
+  }
+
+  struct stat status;
+
+  if (::fstat(fd, &status) == 0) {
+    size_ = size_t(status.st_size);
+
+    // empty files can't be mapped, they are open with no content
+    if (size_ == 0) {
+      open_ = true;
+    } else {
+      void *data = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+
+      if (data != MAP_FAILED) {
+        ::madvise(data, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<const char *>(data);
+        open_ = true;
+      } else {
+        size_ = 0;
+      }
+    }
+  }
+
+  // the mapping stays valid after the descriptor is closed
+  ::close(fd);
+#else
+  std::ifstream file{path, std::ios::binary};
+
+  if (!file.is_open()) {
+    return;
+  }
+
+  content_.assign(std::istreambuf_iterator<char>{file},
+                  std::istreambuf_iterator<char>{});
+  data_ = content_.data();
+  size_ = content_.size();
+  open_ = true;
+#endif
+}
+
+inline MappedFile::~MappedFile() {
+#ifdef JSON_MMAP
+  if (data_ != nullptr) {
+    ::munmap(const_cast<char *>(data_), size_);
+  }
+#endif
+}
+
+inline bool MappedFile::is_open() const {
+  return open_;
+}
+
+inline const char *MappedFile::begin() const {
+  return data_;
+}
+
+inline const char *MappedFile::end() const {
+  return data_ + size_;
+}
+
+inline size_t MappedFile::size() const {
+  return size_;
+}
+}  // namespace json::utils
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <utility>
 #include <variant>
 
 namespace json::utils {
@@ -68,7 +69,7 @@ const E &Result<T, E>::error() const {
 template <typename TT, typename EE>
 Result<TT, EE> Ok(TT t) {
   Result<TT, EE> result;
-  result.data_.template emplace<0>(t);
+  result.data_.template emplace<0>(std::move(t));
 
   return result;
 }
@@ -76,7 +77,7 @@ Result<TT, EE> Ok(TT t) {
 template <typename TT, typename EE>
 Result<TT, EE> Error(EE e) {
   Result<TT, EE> result;
-  result.data_.template emplace<1>(e);
+  result.data_.template emplace<1>(std::move(e));
 
   return result;
 }
@@ -0,0 +1,352 @@
+#pragma once
+
+#include <stdint.h>
+#include <cstddef>
+#include "json/utils/char_class.h"
+
+// SIMD kernels are only built for x86 with GCC or Clang, where the
+// instruction set of a single function can be picked with a target attribute.
+// Define JSON_NO_SIMD to always use the scalar kernels.
+#if !defined(JSON_NO_SIMD) && defined(__GNUC__) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define JSON_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+namespace json::utils::simd {
+/**
+ * @brief Instruction sets the kernels can be built with
+ */
+enum class Isa : char {
+  kScalar,
+  kSse42,
+  kAvx2,
+};
+
+/**
+ * @brief Find the best instruction set supported by the running cpu
+ * @returns the instruction set, computed once and cached
+ */
+Isa DetectIsa();
+
+/**
+ * @brief Bitmaps of the letters of interest in a block of 64 bytes, bit i
+ * describes byte i of the block
+ */
+struct BlockMasks {
+  uint64_t quote;
+  uint64_t backslash;
+  uint64_t structural;
+  uint64_t whitespace;
+};
+
+/**
+ * @brief Function that classifies the 64 bytes starting at `block`
+ */
+using Classifier = void (*)(const char *block, BlockMasks &masks);
+
+/**
+ * @brief Classify a block one byte at a time
+ */
+void ClassifyScalar(const char *block, BlockMasks &masks);
+
+#ifdef JSON_SIMD_X86
+/**
+ * @brief Classify a block 16 bytes at a time
+ */
+__attribute__((target("sse4.2"))) void ClassifySse42(const char *block,
+                                                     BlockMasks &masks);
+
+/**
+ * @brief Classify a block 32 bytes at a time
+ */
+__attribute__((target("avx2"))) void ClassifyAvx2(const char *block,
+                                                  BlockMasks &masks);
+#endif
+
+/**
+ * @brief Count the trailing zero bits of a non zero integer
+ */
+int TrailingZeros(uint64_t bits);
+
+/**
+ * @brief Get the classifier for an instruction set
+ * @param isa the instruction set, must be supported by the running cpu
+ * @returns the classifier
+ */
+Classifier SelectClassifier(Isa isa = DetectIsa());
+
+/**
+ * @brief Function that finds the first quote or backslash in [begin, end)
+ */
+using Finder = const char *(*)(const char *begin, const char *end);
+
+/**
+ * @brief Find the first quote or backslash one byte at a time
+ * @returns pointer to the letter, `end` if there is none
+ */
+const char *FindQuoteOrBackslashScalar(const char *begin, const char *end);
+
+#ifdef JSON_SIMD_X86
+/**
+ * @brief Find the first quote or backslash 16 bytes at a time
+ * @returns pointer to the letter, `end` if there is none
+ */
+__attribute__((target("sse4.2"))) const char *FindQuoteOrBackslashSse42(
+    const char *begin, const char *end);
+
+/**
+ * @brief Find the first quote or backslash 32 bytes at a time
+ * @returns pointer to the letter, `end` if there is none
+ */
+__attribute__((target("avx2"))) const char *FindQuoteOrBackslashAvx2(
+    const char *begin, const char *end);
+#endif
+
+/**
+ * @brief Get the quote or backslash finder for an instruction set
+ * @param isa the instruction set, must be supported by the running cpu
+ * @returns the finder
+ */
+Finder SelectFinder(Isa isa = DetectIsa());
+
+/**
+ * @brief Find the first quote or backslash in [begin, end), using the best
+ * instruction set of the running cpu for `char`
+ * @returns pointer to the letter, `end` if there is none
+ */
+template <typename CharT>
+const CharT *FindQuoteOrBackslash(const CharT *begin, const CharT *end);
+}  // namespace json::utils::simd
+
+// Implementations
+
+namespace json::utils::simd {
+inline Isa DetectIsa() {
+#ifdef JSON_SIMD_X86
+  static const Isa isa = []() {
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2")) {
+      return Isa::kAvx2;
+    }
+
+    if (__builtin_cpu_supports("sse4.2")) {
+      return Isa::kSse42;
+    }
+
+    return Isa::kScalar;
+  }();
+
+  return isa;
+#else
+  return Isa::kScalar;
+#endif
+}
+
+inline int TrailingZeros(uint64_t bits) {
+#ifdef __GNUC__
+  return __builtin_ctzll(bits);
+#else
+  int count = 0;
+
+  while ((bits & 1) == 0) {
+    bits >>= 1;
+    ++count;
+  }
+
+  return count;
+#endif
+}
+
+inline void ClassifyScalar(const char *block, BlockMasks &masks) {
+  masks = BlockMasks{};
+
+  for (int i = 0; i < 64; ++i) {
+    uint64_t bit = uint64_t{1} << i;
+    uint8_t classes = char_class::Lookup(block[i]).classes;
+
+    if (block[i] == '\"') {
+      masks.quote |= bit;
+    } else if (block[i] == '\\') {
+      masks.backslash |= bit;
+    } else if ((classes & char_class::kStructural) != 0) {
+      masks.structural |= bit;
+    } else if ((classes & char_class::kWhitespace) != 0) {
+      masks.whitespace |= bit;
+    }
+  }
+}
+
+#ifdef JSON_SIMD_X86
+inline void ClassifySse42(const char *block, BlockMasks &masks) {
+  const __m128i quote = _mm_set1_epi8('\"');
+  const __m128i backslash = _mm_set1_epi8('\\');
+  // pcmpestrm against the set of structural letters
+  const __m128i structurals = _mm_setr_epi8('{', '}', '[', ']', ':', ',', 0,
+                                            0, 0, 0, 0, 0, 0, 0, 0, 0);
+  const __m128i whitespaces = _mm_setr_epi8(' ', '\t', '\r', '\n', 0, 0, 0, 0,
+                                            0, 0, 0, 0, 0, 0, 0, 0);
+  constexpr int kMode = _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_BIT_MASK;
+
+  masks = BlockMasks{};
+
+  for (int i = 0; i < 4; ++i) {
+    __m128i chunk =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + i * 16));
+    int shift = i * 16;
+
+    masks.quote |= uint64_t(uint16_t(_mm_movemask_epi8(
+                       _mm_cmpeq_epi8(chunk, quote))))
+                   << shift;
+    masks.backslash |= uint64_t(uint16_t(_mm_movemask_epi8(
+                           _mm_cmpeq_epi8(chunk, backslash))))
+                       << shift;
+    masks.structural |= uint64_t(uint16_t(_mm_cvtsi128_si32(
+                            _mm_cmpestrm(structurals, 6, chunk, 16, kMode))))
+                        << shift;
+    masks.whitespace |= uint64_t(uint16_t(_mm_cvtsi128_si32(
+                            _mm_cmpestrm(whitespaces, 4, chunk, 16, kMode))))
+                        << shift;
+  }
+}
+
+inline void ClassifyAvx2(const char *block, BlockMasks &masks) {
+  masks = BlockMasks{};
+
+  for (int i = 0; i < 2; ++i) {
+    __m256i chunk =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block + i * 32));
+    int shift = i * 32;
+
+    __m256i quote = _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\"'));
+    __m256i backslash = _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\\'));
+
+    __m256i structural = _mm256_or_si256(
+        _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('{')),
+                        _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('}'))),
+        _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('[')),
+                        _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(']'))));
+    structural = _mm256_or_si256(
+        structural,
+        _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(':')),
+                        _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(','))));
+
+    __m256i whitespace = _mm256_or_si256(
+        _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(' ')),
+                        _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\t'))),
+        _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\r')),
+                        _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\n'))));
+
+    masks.quote |= uint64_t(uint32_t(_mm256_movemask_epi8(quote))) << shift;
+    masks.backslash |= uint64_t(uint32_t(_mm256_movemask_epi8(backslash)))
+                       << shift;
+    masks.structural |= uint64_t(uint32_t(_mm256_movemask_epi8(structural)))
+                        << shift;
+    masks.whitespace |= uint64_t(uint32_t(_mm256_movemask_epi8(whitespace)))
+                        << shift;
+  }
+}
+#endif
+
+inline Classifier SelectClassifier(Isa isa) {
+#ifdef JSON_SIMD_X86
+  switch (isa) {
+    case Isa::kAvx2:
+      return ClassifyAvx2;
+    case Isa::kSse42:
+      return ClassifySse42;
+    default:
+      break;
+  }
+#endif
+
+  return ClassifyScalar;
+}
+
+inline const char *FindQuoteOrBackslashScalar(const char *begin,
+                                              const char *end) {
+  while (begin != end && *begin != '\"' && *begin != '\\') {
+    ++begin;
+  }
+
+  return begin;
+}
+
+#ifdef JSON_SIMD_X86
+inline const char *FindQuoteOrBackslashSse42(const char *begin,
+                                             const char *end) {
+  const __m128i quote = _mm_set1_epi8('\"');
+  const __m128i backslash = _mm_set1_epi8('\\');
+
+  while (end - begin >= 16) {
+    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(begin));
+    int mask = _mm_movemask_epi8(
+        _mm_or_si128(_mm_cmpeq_epi8(chunk, quote),
+                     _mm_cmpeq_epi8(chunk, backslash)));
+
+    if (mask != 0) {
+      return begin + TrailingZeros(uint64_t(mask));
+    }
+
+    begin += 16;
+  }
+
+  return FindQuoteOrBackslashScalar(begin, end);
+}
+
+inline const char *FindQuoteOrBackslashAvx2(const char *begin,
+                                            const char *end) {
+  const __m256i quote = _mm256_set1_epi8('\"');
+  const __m256i backslash = _mm256_set1_epi8('\\');
+
+  while (end - begin >= 32) {
+    __m256i chunk =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(begin));
+    uint32_t mask = uint32_t(_mm256_movemask_epi8(
+        _mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote),
+                        _mm256_cmpeq_epi8(chunk, backslash))));
+
+    if (mask != 0) {
+      return begin + TrailingZeros(mask);
+    }
+
+    begin += 32;
+  }
+
+  return FindQuoteOrBackslashSse42(begin, end);
+}
+#endif
+
+inline Finder SelectFinder(Isa isa) {
+#ifdef JSON_SIMD_X86
+  switch (isa) {
+    case Isa::kAvx2:
+      return FindQuoteOrBackslashAvx2;
+    case Isa::kSse42:
+      return FindQuoteOrBackslashSse42;
+    default:
+      break;
+  }
+#endif
+
+  return FindQuoteOrBackslashScalar;
+}
+
+template <typename CharT>
+const CharT *FindQuoteOrBackslash(const CharT *begin, const CharT *end) {
+  if constexpr (sizeof(CharT) == 1) {
+    static const Finder finder = SelectFinder();
+
+    return reinterpret_cast<const CharT *>(
+        finder(reinterpret_cast<const char *>(begin),
+               reinterpret_cast<const char *>(end)));
+  } else {
+    while (begin != end && *begin != CharT('\"') && *begin != CharT('\\')) {
+      ++begin;
+    }
+
+    return begin;
+  }
+}
+}  // namespace json::utils::simd
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace json::utils {
+/**
+ * @brief Fixed number of threads that run the tasks submitted to them, in
+ * the order of submission
+ */
+class ThreadPool {
+ public:
+  /**
+   * @brief Start the threads
+   * @param threads number of threads, at least one thread is started
+   */
+  explicit ThreadPool(size_t threads = std::thread::hardware_concurrency());
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  /**
+   * @brief Run the tasks left, then stop the threads
+   */
+  ~ThreadPool();
+
+  /**
+   * @brief Number of threads
+   */
+  size_t size() const;
+
+  /**
+   * @brief Queue a task
+   * @param task callable taking no argument
+   * @returns future of the result of the task
+   */
+  template <typename TaskT>
+  std::future<std::invoke_result_t<TaskT>> Submit(TaskT &&task);
+
+ private:
+  void Work();
+
+  std::vector<std::thread> threads_;
+  std::deque<std::function<void()>> tasks_;
+  std::mutex mutex_;
+  std::condition_variable ready_;
+  bool stopping_ = false;
+};
+}  // namespace json::utils
+
+// Implementations
+
+namespace json::utils {
+inline ThreadPool::ThreadPool(size_t threads) {
+  threads = std::max<size_t>(threads, 1);
+  threads_.reserve(threads);
+
+  for (size_t i = 0; i < threads; ++i) {
+    threads_.emplace_back(&ThreadPool::Work, this);
+  }
+}
+
+inline ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    stopping_ = true;
+  }
+
+  ready_.notify_all();
+
+  for (std::thread &thread : threads_) {
+    thread.join();
+  }
+}
+
+inline size_t ThreadPool::size() const {
+  return threads_.size();
+}
+
+template <typename TaskT>
+std::future<std::invoke_result_t<TaskT>> ThreadPool::Submit(TaskT &&task) {
+  using ResultT = std::invoke_result_t<TaskT>;
+
+  // std::function must be copyable, the packaged task is shared instead
+  auto packaged = std::make_shared<std::packaged_task<ResultT()>>(
+      std::forward<TaskT>(task));
+  std::future<ResultT> future = packaged->get_future();
+
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    tasks_.emplace_back([packaged]() { (*packaged)(); });
+  }
+
+  ready_.notify_one();
+  return future;
+}
+
+inline void ThreadPool::Work() {
+  while (true) {
+    std::function<void()> task;
+
+    {
+      std::unique_lock<std::mutex> lock{mutex_};
+      ready_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+
+      if (tasks_.empty()) {
+        return;
+      }
+
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+
+    task();
+  }
+}
+}  // namespace json::utils
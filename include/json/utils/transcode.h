@@ -0,0 +1,319 @@
+#pragma once
+
+#include <stdint.h>
+#include <cstddef>
+#include <string>
+#include "json/utils/simd.h"
+#include "json/utils/unicode.h"
+
+namespace json::utils::transcode {
+/**
+ * @brief Function that appends the utf8 bytes of [begin, end) to a string of
+ * utf16 or utf32 letters
+ */
+template <typename CharT>
+using Transcoder = void (*)(const char *begin, const char *end,
+                            std::basic_string<CharT> &output);
+
+/**
+ * @brief Transcode one sequence at a time
+ *
+ * The letters are written as utf16 for 2 bytes letters and as utf32 for 4
+ * bytes letters. Bytes that are not well formed utf8 are replaced with
+ * U+FFFD, one for every maximal invalid subpart.
+ */
+template <typename CharT>
+void TranscodeScalar(const char *begin, const char *end,
+                     std::basic_string<CharT> &output);
+
+#ifdef JSON_SIMD_X86
+/**
+ * @brief Transcode, widening blocks of 16 ascii bytes at once
+ */
+template <typename CharT>
+__attribute__((target("sse4.2"))) void TranscodeSse42(
+    const char *begin, const char *end, std::basic_string<CharT> &output);
+
+/**
+ * @brief Transcode, widening blocks of 32 ascii bytes at once
+ */
+template <typename CharT>
+__attribute__((target("avx2"))) void TranscodeAvx2(
+    const char *begin, const char *end, std::basic_string<CharT> &output);
+#endif
+
+/**
+ * @brief Get the transcoder for an instruction set
+ * @param isa the instruction set, must be supported by the running cpu
+ * @returns the transcoder
+ */
+template <typename CharT>
+Transcoder<CharT> SelectTranscoder(simd::Isa isa = simd::DetectIsa());
+
+/**
+ * @brief Append the utf8 bytes of [begin, end) to a string of utf16 or utf32
+ * letters, using the best instruction set of the running cpu
+ */
+template <typename CharT>
+void Transcode(const char *begin, const char *end,
+               std::basic_string<CharT> &output);
+}  // namespace json::utils::transcode
+
+// Implementations
+
+namespace json::utils::transcode {
+namespace detail {
+/**
+ * @brief Decode the sequence starting at a byte
+ * @param cursor pointer to the lead byte
+ * @param last pointer past the last byte
+ * @param code_point set to the code point, U+FFFD if the sequence is invalid
+ * @returns pointer past the sequence, or past the invalid subpart
+ */
+inline const uint8_t *Decode(const uint8_t *cursor, const uint8_t *last,
+                             uint32_t &code_point) {
+  uint8_t lead = *cursor;
+
+  if (lead < 0x80) {
+    code_point = lead;
+    return cursor + 1;
+  }
+
+  // the range of the second byte depends on the lead byte, see table 3-7 of
+  // the unicode standard
+  ptrdiff_t length;
+  uint8_t low = 0x80;
+  uint8_t high = 0xbf;
+
+  if (lead >= 0xc2 && lead <= 0xdf) {
+    length = 2;
+  } else if (lead == 0xe0) {
+    length = 3;
+    low = 0xa0;
+  } else if (lead == 0xed) {
+    length = 3;
+    high = 0x9f;
+  } else if (lead >= 0xe1 && lead <= 0xef) {
+    length = 3;
+  } else if (lead == 0xf0) {
+    length = 4;
+    low = 0x90;
+  } else if (lead == 0xf4) {
+    length = 4;
+    high = 0x8f;
+  } else if (lead >= 0xf1 && lead <= 0xf3) {
+    length = 4;
+  } else {
+    code_point = unicode::kReplacement;
+    return cursor + 1;
+  }
+
+  code_point = unicode::kReplacement;
+
+  if (last - cursor < 2 || cursor[1] < low || cursor[1] > high) {
+    return cursor + 1;
+  }
+
+  uint32_t value = lead & (0x7f >> length);
+  value = (value << 6) | (cursor[1] & 0x3f);
+
+  for (ptrdiff_t i = 2; i < length; ++i) {
+    if (cursor + i == last || (cursor[i] & 0xc0) != 0x80) {
+      return cursor + i;
+    }
+
+    value = (value << 6) | (cursor[i] & 0x3f);
+  }
+
+  code_point = value;
+  return cursor + length;
+}
+
+/**
+ * @brief Write a code point as utf16 or utf32
+ * @returns pointer past the letters written
+ */
+template <typename CharT>
+CharT *Put(uint32_t code_point, CharT *output) {
+  static_assert(sizeof(CharT) == 2 || sizeof(CharT) == 4,
+                "transcoding writes utf16 or utf32");
+
+  if constexpr (sizeof(CharT) == 2) {
+    if (code_point >= 0x10000) {
+      code_point -= 0x10000;
+      *output++ = CharT(0xd800 | (code_point >> 10));
+      *output++ = CharT(0xdc00 | (code_point & 0x3ff));
+      return output;
+    }
+  }
+
+  *output++ = CharT(code_point);
+  return output;
+}
+
+/**
+ * @brief Decode the sequences that start before `stop`
+ * @returns pointer past the letters written
+ */
+template <typename CharT>
+CharT *DecodeRun(const uint8_t *&cursor, const uint8_t *stop,
+                 const uint8_t *last, CharT *output) {
+  while (cursor < stop) {
+    uint32_t code_point;
+    cursor = Decode(cursor, last, code_point);
+    output = Put(code_point, output);
+  }
+
+  return output;
+}
+
+/**
+ * @brief Make room for the letters of [begin, end), utf8 never has fewer
+ * bytes than the utf16 or utf32 letters of the same text
+ * @returns pointer to the first letter to write
+ */
+template <typename CharT>
+CharT *Reserve(const char *begin, const char *end,
+               std::basic_string<CharT> &output) {
+  size_t size = output.size();
+  output.resize(size + size_t(end - begin));
+
+  return &output[0] + size;
+}
+
+/**
+ * @brief Drop the room that was not written to
+ */
+template <typename CharT>
+void Shrink(CharT *stop, std::basic_string<CharT> &output) {
+  output.resize(size_t(stop - output.data()));
+}
+}  // namespace detail
+
+template <typename CharT>
+void TranscodeScalar(const char *begin, const char *end,
+                     std::basic_string<CharT> &output) {
+  if (begin == end) {
+    return;
+  }
+
+  const uint8_t *cursor = reinterpret_cast<const uint8_t *>(begin);
+  const uint8_t *last = reinterpret_cast<const uint8_t *>(end);
+  CharT *letters = detail::Reserve(begin, end, output);
+
+  letters = detail::DecodeRun(cursor, last, last, letters);
+  detail::Shrink(letters, output);
+}
+
+#ifdef JSON_SIMD_X86
+template <typename CharT>
+void TranscodeSse42(const char *begin, const char *end,
+                    std::basic_string<CharT> &output) {
+  if (begin == end) {
+    return;
+  }
+
+  const uint8_t *cursor = reinterpret_cast<const uint8_t *>(begin);
+  const uint8_t *last = reinterpret_cast<const uint8_t *>(end);
+  CharT *letters = detail::Reserve(begin, end, output);
+
+  while (last - cursor >= 16) {
+    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(cursor));
+
+    // blocks with a non ascii byte are decoded one sequence at a time
+    if (_mm_movemask_epi8(block) != 0) {
+      letters = detail::DecodeRun(cursor, cursor + 16, last, letters);
+      continue;
+    }
+
+    __m128i *store = reinterpret_cast<__m128i *>(letters);
+
+    if constexpr (sizeof(CharT) == 2) {
+      _mm_storeu_si128(store, _mm_cvtepu8_epi16(block));
+      _mm_storeu_si128(store + 1, _mm_cvtepu8_epi16(_mm_srli_si128(block, 8)));
+    } else {
+      _mm_storeu_si128(store, _mm_cvtepu8_epi32(block));
+      _mm_storeu_si128(store + 1, _mm_cvtepu8_epi32(_mm_srli_si128(block, 4)));
+      _mm_storeu_si128(store + 2, _mm_cvtepu8_epi32(_mm_srli_si128(block, 8)));
+      _mm_storeu_si128(store + 3,
+                       _mm_cvtepu8_epi32(_mm_srli_si128(block, 12)));
+    }
+
+    cursor += 16;
+    letters += 16;
+  }
+
+  letters = detail::DecodeRun(cursor, last, last, letters);
+  detail::Shrink(letters, output);
+}
+
+template <typename CharT>
+void TranscodeAvx2(const char *begin, const char *end,
+                   std::basic_string<CharT> &output) {
+  if (begin == end) {
+    return;
+  }
+
+  const uint8_t *cursor = reinterpret_cast<const uint8_t *>(begin);
+  const uint8_t *last = reinterpret_cast<const uint8_t *>(end);
+  CharT *letters = detail::Reserve(begin, end, output);
+
+  while (last - cursor >= 32) {
+    __m256i block =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(cursor));
+
+    // blocks with a non ascii byte are decoded one sequence at a time
+    if (_mm256_movemask_epi8(block) != 0) {
+      letters = detail::DecodeRun(cursor, cursor + 32, last, letters);
+      continue;
+    }
+
+    __m128i low = _mm256_castsi256_si128(block);
+    __m128i high = _mm256_extracti128_si256(block, 1);
+    __m256i *store = reinterpret_cast<__m256i *>(letters);
+
+    if constexpr (sizeof(CharT) == 2) {
+      _mm256_storeu_si256(store, _mm256_cvtepu8_epi16(low));
+      _mm256_storeu_si256(store + 1, _mm256_cvtepu8_epi16(high));
+    } else {
+      _mm256_storeu_si256(store, _mm256_cvtepu8_epi32(low));
+      _mm256_storeu_si256(store + 1,
+                          _mm256_cvtepu8_epi32(_mm_srli_si128(low, 8)));
+      _mm256_storeu_si256(store + 2, _mm256_cvtepu8_epi32(high));
+      _mm256_storeu_si256(store + 3,
+                          _mm256_cvtepu8_epi32(_mm_srli_si128(high, 8)));
+    }
+
+    cursor += 32;
+    letters += 32;
+  }
+
+  letters = detail::DecodeRun(cursor, last, last, letters);
+  detail::Shrink(letters, output);
+}
+#endif
+
+template <typename CharT>
+Transcoder<CharT> SelectTranscoder(simd::Isa isa) {
+#ifdef JSON_SIMD_X86
+  switch (isa) {
+    case simd::Isa::kAvx2:
+      return TranscodeAvx2<CharT>;
+    case simd::Isa::kSse42:
+      return TranscodeSse42<CharT>;
+    default:
+      break;
+  }
+#endif
+
+  return TranscodeScalar<CharT>;
+}
+
+template <typename CharT>
+void Transcode(const char *begin, const char *end,
+               std::basic_string<CharT> &output) {
+  static const Transcoder<CharT> transcoder = SelectTranscoder<CharT>();
+
+  transcoder(begin, end, output);
+}
+}  // namespace json::utils::transcode
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <stdint.h>
+#include <string>
+
+namespace json::utils::unicode {
+/**
+ * @brief Code point used in place of surrogates that are not part of a pair
+ */
+inline constexpr uint32_t kReplacement = 0xfffd;
+
+/**
+ * @brief Determine if a utf16 unit is the first unit of a surrogate pair
+ */
+constexpr bool IsHighSurrogate(uint32_t unit);
+
+/**
+ * @brief Determine if a utf16 unit is the second unit of a surrogate pair
+ */
+constexpr bool IsLowSurrogate(uint32_t unit);
+
+/**
+ * @brief Get the code point of a surrogate pair
+ * @param high the first unit of the pair
+ * @param low the second unit of the pair
+ * @returns the code point
+ */
+constexpr uint32_t Combine(uint32_t high, uint32_t low);
+
+/**
+ * @brief Append a code point to a string, encoded as utf8 for 1 byte
+ * letters, utf16 for 2 bytes letters and utf32 for 4 bytes letters
+ * @param code_point the code point, must not be a surrogate
+ * @param output the string to append to
+ */
+template <typename CharT>
+void Append(uint32_t code_point, std::basic_string<CharT> &output);
+}  // namespace json::utils::unicode
+
+// Implementations
+
+namespace json::utils::unicode {
+constexpr bool IsHighSurrogate(uint32_t unit) {
+  return unit >= 0xd800 && unit <= 0xdbff;
+}
+
+constexpr bool IsLowSurrogate(uint32_t unit) {
+  return unit >= 0xdc00 && unit <= 0xdfff;
+}
+
+constexpr uint32_t Combine(uint32_t high, uint32_t low) {
+  return 0x10000 + ((high - 0xd800) << 10) + (low - 0xdc00);
+}
+
+template <typename CharT>
+void Append(uint32_t code_point, std::basic_string<CharT> &output) {
+  if constexpr (sizeof(CharT) == 1) {
+    if (code_point < 0x80) {
+      output += CharT(code_point);
+    } else if (code_point < 0x800) {
+      const CharT letters[] = {CharT(0xc0 | (code_point >> 6)),
+                               CharT(0x80 | (code_point & 0x3f))};
+      output.append(letters, 2);
+    } else if (code_point < 0x10000) {
+      const CharT letters[] = {CharT(0xe0 | (code_point >> 12)),
+                               CharT(0x80 | ((code_point >> 6) & 0x3f)),
+                               CharT(0x80 | (code_point & 0x3f))};
+      output.append(letters, 3);
+    } else {
+      const CharT letters[] = {CharT(0xf0 | (code_point >> 18)),
+                               CharT(0x80 | ((code_point >> 12) & 0x3f)),
+                               CharT(0x80 | ((code_point >> 6) & 0x3f)),
+                               CharT(0x80 | (code_point & 0x3f))};
+      output.append(letters, 4);
+    }
+  } else if constexpr (sizeof(CharT) == 2) {
+    if (code_point < 0x10000) {
+      output += CharT(code_point);
+    } else {
+      code_point -= 0x10000;
+      const CharT units[] = {CharT(0xd800 | (code_point >> 10)),
+                             CharT(0xdc00 | (code_point & 0x3ff))};
+      output.append(units, 2);
+    }
+  } else {
+    output += CharT(code_point);
+  }
+}
+}  // namespace json::utils::unicode
@@ -0,0 +1,375 @@
+#pragma once
+
+#include <stdint.h>
+#include <cstddef>
+#include <cstring>
+#include "json/utils/simd.h"
+
+namespace json::utils::utf8 {
+/**
+ * @brief Function that determines if [begin, end) is well formed utf8
+ */
+using Validator = bool (*)(const char *begin, const char *end);
+
+/**
+ * @brief Validate one byte at a time, skipping ascii 8 bytes at a time
+ * @returns `true` if the bytes are well formed utf8
+ */
+bool ValidateScalar(const char *begin, const char *end);
+
+#ifdef JSON_SIMD_X86
+/**
+ * @brief Validate 16 bytes at a time with lookup tables
+ * @returns `true` if the bytes are well formed utf8
+ */
+__attribute__((target("sse4.2"))) bool ValidateSse42(const char *begin,
+                                                     const char *end);
+
+/**
+ * @brief Validate 32 bytes at a time with lookup tables
+ * @returns `true` if the bytes are well formed utf8
+ */
+__attribute__((target("avx2"))) bool ValidateAvx2(const char *begin,
+                                                  const char *end);
+#endif
+
+/**
+ * @brief Get the validator for an instruction set
+ * @param isa the instruction set, must be supported by the running cpu
+ * @returns the validator
+ */
+Validator SelectValidator(simd::Isa isa = simd::DetectIsa());
+
+/**
+ * @brief Determine if [begin, end) is well formed utf8, using the best
+ * instruction set of the running cpu
+ * @returns `true` if the bytes are well formed utf8
+ */
+bool Validate(const char *begin, const char *end);
+}  // namespace json::utils::utf8
+
+// Implementations
+
+namespace json::utils::utf8 {
+namespace detail {
+// Errors found by looking at the high nibble of a byte, the low nibble of the
+// byte and the high nibble of the byte after it. A pair of bytes is invalid
+// when the three lookups share a bit.
+constexpr uint8_t kTooShort = 1 << 0;
+constexpr uint8_t kTooLong = 1 << 1;
+constexpr uint8_t kOverlong3 = 1 << 2;
+constexpr uint8_t kTooLarge = 1 << 3;
+constexpr uint8_t kSurrogate = 1 << 4;
+constexpr uint8_t kOverlong2 = 1 << 5;
+constexpr uint8_t kTooLarge1000 = 1 << 6;
+constexpr uint8_t kOverlong4 = 1 << 6;
+constexpr uint8_t kTwoConts = 1 << 7;
+constexpr uint8_t kCarry = kTooShort | kTooLong | kTwoConts;
+
+alignas(16) inline constexpr uint8_t kByte1High[16] = {
+    // 0___ ascii
+    kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong,
+    kTooLong,
+    // 10__ continuation
+    kTwoConts, kTwoConts, kTwoConts, kTwoConts,
+    // 1100 two byte lead
+    kTooShort | kOverlong2,
+    // 1101 two byte lead
+    kTooShort,
+    // 1110 three byte lead
+    kTooShort | kOverlong3 | kSurrogate,
+    // 1111 four byte lead
+    kTooShort | kTooLarge | kTooLarge1000 | kOverlong4};
+
+alignas(16) inline constexpr uint8_t kByte1Low[16] = {
+    // 0000
+    kCarry | kOverlong3 | kOverlong2 | kOverlong4,
+    // 0001
+    kCarry | kOverlong2,
+    // 001_
+    kCarry, kCarry,
+    // 0100
+    kCarry | kTooLarge,
+    // 0101, 011_, 1___
+    kCarry | kTooLarge | kTooLarge1000, kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000, kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000, kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000, kCarry | kTooLarge | kTooLarge1000,
+    // 1101
+    kCarry | kTooLarge | kTooLarge1000 | kSurrogate,
+    // 1110, 1111
+    kCarry | kTooLarge | kTooLarge1000, kCarry | kTooLarge | kTooLarge1000};
+
+alignas(16) inline constexpr uint8_t kByte2High[16] = {
+    // 0___ ascii
+    kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort,
+    kTooShort, kTooShort,
+    // 1000
+    kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge1000 |
+        kOverlong4,
+    // 1001
+    kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge,
+    // 101_
+    kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,
+    kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,
+    // 11__ lead
+    kTooShort, kTooShort, kTooShort, kTooShort};
+
+// a block ending with these bytes, at the same offsets from its end, ends in
+// the middle of a sequence; each byte is the largest value that is not a lead
+// byte of a sequence that long
+alignas(16) inline constexpr uint8_t kMaxValue[32] = {
+    255, 255, 255, 255, 255, 255, 255, 255, 255,  255,  255,  255,  255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255,  255,  255,  255,  255,
+    255, 255, 255, 0xef, 0xdf, 0xbf};
+
+#ifdef JSON_SIMD_X86
+/**
+ * @brief State carried from one block to the next
+ */
+struct Sse42State {
+  __m128i previous;
+  __m128i incomplete;
+  __m128i error;
+};
+
+__attribute__((target("sse4.2"))) inline void CheckSse42(__m128i input,
+                                                         Sse42State &state) {
+  // ascii blocks only need to check that the previous block was complete
+  if (_mm_movemask_epi8(input) == 0) {
+    state.error = _mm_or_si128(state.error, state.incomplete);
+    state.previous = input;
+    state.incomplete = _mm_setzero_si128();
+    return;
+  }
+
+  const __m128i low_nibble = _mm_set1_epi8(0x0f);
+  const __m128i byte_1_high_table =
+      _mm_load_si128(reinterpret_cast<const __m128i *>(kByte1High));
+  const __m128i byte_1_low_table =
+      _mm_load_si128(reinterpret_cast<const __m128i *>(kByte1Low));
+  const __m128i byte_2_high_table =
+      _mm_load_si128(reinterpret_cast<const __m128i *>(kByte2High));
+
+  __m128i prev1 = _mm_alignr_epi8(input, state.previous, 15);
+  __m128i byte_1_high = _mm_shuffle_epi8(
+      byte_1_high_table, _mm_and_si128(_mm_srli_epi16(prev1, 4), low_nibble));
+  __m128i byte_1_low =
+      _mm_shuffle_epi8(byte_1_low_table, _mm_and_si128(prev1, low_nibble));
+  __m128i byte_2_high = _mm_shuffle_epi8(
+      byte_2_high_table, _mm_and_si128(_mm_srli_epi16(input, 4), low_nibble));
+  __m128i special =
+      _mm_and_si128(_mm_and_si128(byte_1_high, byte_1_low), byte_2_high);
+
+  // the 3rd and 4th bytes of sequences must be continuations
+  __m128i prev2 = _mm_alignr_epi8(input, state.previous, 14);
+  __m128i prev3 = _mm_alignr_epi8(input, state.previous, 13);
+  __m128i third = _mm_subs_epu8(prev2, _mm_set1_epi8(char(0xe0 - 0x80)));
+  __m128i fourth = _mm_subs_epu8(prev3, _mm_set1_epi8(char(0xf0 - 0x80)));
+  __m128i must_continue = _mm_and_si128(_mm_or_si128(third, fourth),
+                                        _mm_set1_epi8(char(0x80)));
+
+  state.error =
+      _mm_or_si128(state.error, _mm_xor_si128(must_continue, special));
+  state.incomplete = _mm_subs_epu8(
+      input,
+      _mm_loadu_si128(reinterpret_cast<const __m128i *>(kMaxValue + 16)));
+  state.previous = input;
+}
+
+/**
+ * @brief State carried from one block to the next
+ */
+struct Avx2State {
+  __m256i previous;
+  __m256i incomplete;
+  __m256i error;
+};
+
+__attribute__((target("avx2"))) inline void CheckAvx2(__m256i input,
+                                                      Avx2State &state) {
+  // ascii blocks only need to check that the previous block was complete
+  if (_mm256_movemask_epi8(input) == 0) {
+    state.error = _mm256_or_si256(state.error, state.incomplete);
+    state.previous = input;
+    state.incomplete = _mm256_setzero_si256();
+    return;
+  }
+
+  const __m256i low_nibble = _mm256_set1_epi8(0x0f);
+  const __m256i byte_1_high_table = _mm256_broadcastsi128_si256(
+      _mm_load_si128(reinterpret_cast<const __m128i *>(kByte1High)));
+  const __m256i byte_1_low_table = _mm256_broadcastsi128_si256(
+      _mm_load_si128(reinterpret_cast<const __m128i *>(kByte1Low)));
+  const __m256i byte_2_high_table = _mm256_broadcastsi128_si256(
+      _mm_load_si128(reinterpret_cast<const __m128i *>(kByte2High)));
+
+  // the last 16 bytes of the previous block followed by the first 16 bytes
+  // of this block, to shift bytes across the two lanes
+  __m256i carried = _mm256_permute2x128_si256(state.previous, input, 0x21);
+
+  __m256i prev1 = _mm256_alignr_epi8(input, carried, 15);
+  __m256i byte_1_high = _mm256_shuffle_epi8(
+      byte_1_high_table,
+      _mm256_and_si256(_mm256_srli_epi16(prev1, 4), low_nibble));
+  __m256i byte_1_low = _mm256_shuffle_epi8(
+      byte_1_low_table, _mm256_and_si256(prev1, low_nibble));
+  __m256i byte_2_high = _mm256_shuffle_epi8(
+      byte_2_high_table,
+      _mm256_and_si256(_mm256_srli_epi16(input, 4), low_nibble));
+  __m256i special = _mm256_and_si256(_mm256_and_si256(byte_1_high, byte_1_low),
+                                     byte_2_high);
+
+  // the 3rd and 4th bytes of sequences must be continuations
+  __m256i prev2 = _mm256_alignr_epi8(input, carried, 14);
+  __m256i prev3 = _mm256_alignr_epi8(input, carried, 13);
+  __m256i third =
+      _mm256_subs_epu8(prev2, _mm256_set1_epi8(char(0xe0 - 0x80)));
+  __m256i fourth =
+      _mm256_subs_epu8(prev3, _mm256_set1_epi8(char(0xf0 - 0x80)));
+  __m256i must_continue = _mm256_and_si256(_mm256_or_si256(third, fourth),
+                                           _mm256_set1_epi8(char(0x80)));
+
+  state.error =
+      _mm256_or_si256(state.error, _mm256_xor_si256(must_continue, special));
+  state.incomplete = _mm256_subs_epu8(
+      input, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(kMaxValue)));
+  state.previous = input;
+}
+#endif
+}  // namespace detail
+
+inline bool ValidateScalar(const char *begin, const char *end) {
+  const uint8_t *cursor = reinterpret_cast<const uint8_t *>(begin);
+  const uint8_t *last = reinterpret_cast<const uint8_t *>(end);
+
+  while (cursor != last) {
+    // skip ascii 8 bytes at a time
+    if (last - cursor >= 8) {
+      uint64_t word;
+      std::memcpy(&word, cursor, 8);
+
+      if ((word & 0x8080808080808080ULL) == 0) {
+        cursor += 8;
+        continue;
+      }
+    }
+
+    uint8_t lead = *cursor;
+
+    if (lead < 0x80) {
+      ++cursor;
+      continue;
+    }
+
+    // the range of the second byte depends on the lead byte, see table 3-7
+    // of the unicode standard
+    ptrdiff_t length;
+    uint8_t low = 0x80;
+    uint8_t high = 0xbf;
+
+    if (lead >= 0xc2 && lead <= 0xdf) {
+      length = 2;
+    } else if (lead == 0xe0) {
+      length = 3;
+      low = 0xa0;
+    } else if (lead == 0xed) {
+      length = 3;
+      high = 0x9f;
+    } else if (lead >= 0xe1 && lead <= 0xef) {
+      length = 3;
+    } else if (lead == 0xf0) {
+      length = 4;
+      low = 0x90;
+    } else if (lead == 0xf4) {
+      length = 4;
+      high = 0x8f;
+    } else if (lead >= 0xf1 && lead <= 0xf3) {
+      length = 4;
+    } else {
+      return false;
+    }
+
+    if (last - cursor < length || cursor[1] < low || cursor[1] > high) {
+      return false;
+    }
+
+    for (ptrdiff_t i = 2; i < length; ++i) {
+      if ((cursor[i] & 0xc0) != 0x80) {
+        return false;
+      }
+    }
+
+    cursor += length;
+  }
+
+  return true;
+}
+
+#ifdef JSON_SIMD_X86
+inline bool ValidateSse42(const char *begin, const char *end) {
+  detail::Sse42State state{_mm_setzero_si128(), _mm_setzero_si128(),
+                           _mm_setzero_si128()};
+
+  for (; end - begin >= 16; begin += 16) {
+    detail::CheckSse42(
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(begin)), state);
+  }
+
+  // pad the last block with ascii, which ends any sequence left open
+  if (begin != end) {
+    char tail[16] = {};
+    std::memcpy(tail, begin, size_t(end - begin));
+    detail::CheckSse42(_mm_loadu_si128(reinterpret_cast<const __m128i *>(tail)),
+                       state);
+  }
+
+  __m128i error = _mm_or_si128(state.error, state.incomplete);
+
+  return _mm_testz_si128(error, error) != 0;
+}
+
+inline bool ValidateAvx2(const char *begin, const char *end) {
+  detail::Avx2State state{_mm256_setzero_si256(), _mm256_setzero_si256(),
+                          _mm256_setzero_si256()};
+
+  for (; end - begin >= 32; begin += 32) {
+    detail::CheckAvx2(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(begin)), state);
+  }
+
+  // pad the last block with ascii, which ends any sequence left open
+  if (begin != end) {
+    char tail[32] = {};
+    std::memcpy(tail, begin, size_t(end - begin));
+    detail::CheckAvx2(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(tail)), state);
+  }
+
+  __m256i error = _mm256_or_si256(state.error, state.incomplete);
+
+  return _mm256_testz_si256(error, error) != 0;
+}
+#endif
+
+inline Validator SelectValidator(simd::Isa isa) {
+#ifdef JSON_SIMD_X86
+  switch (isa) {
+    case simd::Isa::kAvx2:
+      return ValidateAvx2;
+    case simd::Isa::kSse42:
+      return ValidateSse42;
+    default:
+      break;
+  }
+#endif
+
+  return ValidateScalar;
+}
+
+inline bool Validate(const char *begin, const char *end) {
+  static const Validator validator = SelectValidator();
+
+  return validator(begin, end);
+}
+}  // namespace json::utils::utf8
@@ -3,6 +3,7 @@
 #include <functional>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <variant>
 
 namespace json {
@@ -36,6 +37,12 @@ class BasicKey {
    */
   BasicKey(const std::basic_string<CharT> &key);
 
+  /**
+   * @brief Construt a key with-ownership
+   * @param key the key to move from
+   */
+  BasicKey(std::basic_string<CharT> &&key);
+
   /**
    * @brief Construt a key without-ownership
    * @param key the key to reference to
@@ -77,6 +84,11 @@ BasicKey<CharT>::BasicKey(const std::basic_string<CharT> &key) {
   data_.template emplace<0>(key);
 }
 
+template <typename CharT>
+BasicKey<CharT>::BasicKey(std::basic_string<CharT> &&key) {
+  data_.template emplace<0>(std::move(key));
+}
+
 template <typename CharT>
 BasicKey<CharT>::BasicKey(const CharT *key) {
   data_.template emplace<1>(key);
@@ -0,0 +1,541 @@
+#pragma once
+
+#include <stddef.h>
+#include <string>
+#include <string_view>
+#include <variant>
+#include "json/parser/parser.h"
+#include "json/token/compact_token.h"
+#include "json/token/structural_index.h"
+#include "json/token/tokenizer.h"
+#include "json/utils/error_code.h"
+#include "json/utils/letters.h"
+#include "json/value/basic_value.h"
+
+namespace json {
+template <typename CharT>
+class BasicLazyDocument;
+
+/**
+ * @brief A value of a `BasicLazyDocument`, which is only read when asked for
+ *
+ * A value is the position of its first token in the structural index of the
+ * document, looking up a member or an element walks the tokens of the value
+ * and jumps over the members and elements before it. Values that are not
+ * found are missing, and missing values have no members or elements.
+ *
+ * The document is not checked when it is indexed, so the letters of a string,
+ * number or boolean may not be valid. Such a value reads as empty, 0 or
+ * `false`, and `error()` tells it apart from a valid one.
+ *
+ * The document must outlive its values.
+ */
+template <typename CharT>
+class BasicLazyValue {
+ public:
+  using Type = typename BasicValue<CharT>::Type;
+  using String = std::basic_string<CharT>;
+  using Key = std::basic_string_view<CharT>;
+
+  /**
+   * @brief Get the type of the value, found out of its first letter
+   * @returns the type, `Type::kNull` for missing values
+   */
+  Type type() const;
+
+  /**
+   * @brief Determine if the value was not found
+   * @returns `true` if the key or index looked up did not exist
+   */
+  bool IsMissing() const;
+
+  bool IsObject() const;
+  bool IsArray() const;
+
+  /**
+   * @brief Determine if an object has a member
+   * @param key the key of the member
+   * @returns `true` if found, `false` otherwise or if not an object
+   */
+  bool Contains(Key key) const;
+
+  /**
+   * @brief Find a member of an object, stopping at the first member with the
+   * key
+   * @param key the key of the member
+   * @returns the member, missing if not found or if not an object
+   */
+  BasicLazyValue<CharT> operator[](Key key) const;
+
+  /**
+   * @brief Find an element of an array
+   * @param index the index of the element
+   * @returns the element, missing if not found or if not an array
+   */
+  BasicLazyValue<CharT> operator[](size_t index) const;
+
+  /**
+   * @brief Count the members of an object or the elements of an array
+   * @returns the count, 0 for other values
+   */
+  size_t size() const;
+
+  /**
+   * @brief Get the letters of a string, with escapes decoded
+   * @returns the letters, empty if not a string or not valid
+   */
+  String string() const;
+
+  /**
+   * @brief Get the value of a number
+   * @returns the value, 0 if not a number or not valid
+   */
+  double number() const;
+
+  /**
+   * @brief Get the value of a boolean
+   * @returns the value, `false` if not a boolean or not valid
+   */
+  bool boolean() const;
+
+  /**
+   * @brief Tokenize a string, number, boolean or null value, which must be a
+   * single token
+   * @returns the error of its letters, `ErrorCode::kNone` if they are valid
+   * or if the value is missing, an object or an array
+   */
+  utils::ErrorCode error() const;
+
+  /**
+   * @brief Build the value, with all of its members or elements
+   * @returns the value, null if missing or not valid
+   */
+  BasicValue<CharT> Materialize() const;
+
+ private:
+  friend class BasicLazyDocument<CharT>;
+
+  static constexpr size_t kMissing = ~size_t{0};
+
+  BasicLazyValue(const BasicLazyDocument<CharT> *document, size_t position);
+
+  /**
+   * @brief Get the letter of a token
+   */
+  CharT Letter(size_t position) const;
+
+  /**
+   * @brief Find the token after the value that starts at a token, jumping
+   * over the tokens of objects and arrays
+   */
+  size_t Skip(size_t position) const;
+
+  /**
+   * @brief Find the token after the comma that follows the value that starts
+   * at a token
+   */
+  size_t Next(size_t position) const;
+
+  /**
+   * @brief Get the letters of the value, up to the next token
+   */
+  std::basic_string_view<CharT> Letters() const;
+
+  /**
+   * @brief Extract the token of a scalar value from a tokenizer of its
+   * `Letters()`, and check that nothing follows it
+   */
+  utils::ErrorCode Extract(token::CompactTokenizer<CharT> &tokenizer) const;
+
+  const BasicLazyDocument<CharT> *document_;
+  size_t position_;
+};
+
+/**
+ * @brief A json text that is navigated without being parsed, only the
+ * values that are read are converted
+ *
+ * The text is indexed once by a `token::StructuralIndex`, which records
+ * where every token starts. Looking values up then works on the index, the
+ * letters of strings and whitespaces are never looked at again. The text is
+ * not checked, only the values that are read are tokenized.
+ *
+ * The document does not own the text, which must outlive the document.
+ */
+template <typename CharT>
+class BasicLazyDocument {
+ public:
+  /**
+   * @brief Index a text
+   * @param text the json text
+   */
+  explicit BasicLazyDocument(std::basic_string_view<CharT> text);
+
+  /**
+   * @brief Get the value of the text
+   * @returns the value, missing if the text is empty or has 4GiB letters or
+   * more, which cannot be indexed
+   */
+  BasicLazyValue<CharT> root() const;
+
+  /**
+   * @brief Find a member of the value of the text, see `BasicLazyValue`
+   */
+  BasicLazyValue<CharT> operator[](
+      typename BasicLazyValue<CharT>::Key key) const;
+
+  /**
+   * @brief Find an element of the value of the text, see `BasicLazyValue`
+   */
+  BasicLazyValue<CharT> operator[](size_t index) const;
+
+  /**
+   * @brief Determine if the value of the text has a member
+   */
+  bool Contains(typename BasicLazyValue<CharT>::Key key) const;
+
+ private:
+  friend class BasicLazyValue<CharT>;
+
+  std::basic_string_view<CharT> text_;
+  token::StructuralIndex index_;
+};
+}  // namespace json
+
+// Implementations
+
+namespace json {
+template <typename CharT>
+BasicLazyValue<CharT>::BasicLazyValue(const BasicLazyDocument<CharT> *document,
+                                      size_t position)
+    : document_(document), position_(position) {}
+
+template <typename CharT>
+typename BasicLazyValue<CharT>::Type BasicLazyValue<CharT>::type() const {
+  using namespace utils;
+
+  if (IsMissing()) {
+    return Type::kNull;
+  }
+
+  switch (Letter(position_)) {
+    case letters::kLeftCurleyBrace<CharT>:
+      return Type::kObject;
+    case letters::kLeftSquareBracket<CharT>:
+      return Type::kArray;
+    case letters::kDoubleQuote<CharT>:
+      return Type::kString;
+    case letters::kT<CharT>:
+    case letters::kF<CharT>:
+      return Type::kBoolean;
+    case letters::kN<CharT>:
+      return Type::kNull;
+    default:
+      return Type::kNumber;
+  }
+}
+
+template <typename CharT>
+bool BasicLazyValue<CharT>::IsMissing() const {
+  return position_ == kMissing;
+}
+
+template <typename CharT>
+bool BasicLazyValue<CharT>::IsObject() const {
+  return type() == Type::kObject;
+}
+
+template <typename CharT>
+bool BasicLazyValue<CharT>::IsArray() const {
+  return type() == Type::kArray;
+}
+
+template <typename CharT>
+bool BasicLazyValue<CharT>::Contains(Key key) const {
+  return !(*this)[key].IsMissing();
+}
+
+template <typename CharT>
+BasicLazyValue<CharT> BasicLazyValue<CharT>::operator[](Key key) const {
+  using namespace utils;
+
+  if (!IsObject()) {
+    return {document_, kMissing};
+  }
+
+  const std::basic_string_view<CharT> text = document_->text_;
+  const size_t size = document_->index_.size();
+
+  // every member is a key, a colon and a value
+  for (size_t member = position_ + 1;
+       member + 2 < size &&
+       Letter(member) == letters::kDoubleQuote<CharT> &&
+       Letter(member + 1) == letters::kColon<CharT>;
+       member = Next(member + 2)) {
+    token::CompactTokenizer<CharT> tokenizer{
+        {text.data() + document_->index_[member], text.data() + text.size()}};
+    tokenizer.Extract();
+
+    if (tokenizer.error() == ErrorCode::kNone &&
+        tokenizer.token().string() == key) {
+      return {document_, member + 2};
+    }
+  }
+
+  return {document_, kMissing};
+}
+
+template <typename CharT>
+BasicLazyValue<CharT> BasicLazyValue<CharT>::operator[](size_t index) const {
+  using namespace utils;
+
+  if (!IsArray()) {
+    return {document_, kMissing};
+  }
+
+  const size_t size = document_->index_.size();
+  size_t element = position_ + 1;
+
+  if (element < size &&
+      Letter(element) == letters::kRightSquareBracket<CharT>) {
+    return {document_, kMissing};
+  }
+
+  for (size_t i = 0; i < index && element < size; ++i) {
+    element = Next(element);
+  }
+
+  return {document_, element < size ? element : kMissing};
+}
+
+template <typename CharT>
+size_t BasicLazyValue<CharT>::size() const {
+  using namespace utils;
+
+  if (!IsObject() && !IsArray()) {
+    return 0;
+  }
+
+  const size_t size = document_->index_.size();
+  const bool object = IsObject();
+  const CharT close = object ? letters::kRightCurleyBrace<CharT>
+                             : letters::kRightSquareBracket<CharT>;
+  size_t count = 0;
+
+  for (size_t child = position_ + 1; child < size && Letter(child) != close;
+       child = Next(object ? child + 2 : child)) {
+    ++count;
+  }
+
+  return count;
+}
+
+template <typename CharT>
+typename BasicLazyValue<CharT>::String BasicLazyValue<CharT>::string() const {
+  if (type() != Type::kString) {
+    return {};
+  }
+
+  token::CompactTokenizer<CharT> tokenizer{Letters()};
+
+  if (Extract(tokenizer) != utils::ErrorCode::kNone) {
+    return {};
+  }
+
+  return String{tokenizer.token().string()};
+}
+
+template <typename CharT>
+double BasicLazyValue<CharT>::number() const {
+  if (type() != Type::kNumber) {
+    return 0;
+  }
+
+  token::CompactTokenizer<CharT> tokenizer{Letters()};
+
+  if (Extract(tokenizer) != utils::ErrorCode::kNone) {
+    return 0;
+  }
+
+  return std::visit([](auto value) { return double(value); },
+                    tokenizer.token().NumberValue());
+}
+
+template <typename CharT>
+bool BasicLazyValue<CharT>::boolean() const {
+  if (type() != Type::kBoolean) {
+    return false;
+  }
+
+  token::CompactTokenizer<CharT> tokenizer{Letters()};
+
+  if (Extract(tokenizer) != utils::ErrorCode::kNone) {
+    return false;
+  }
+
+  return tokenizer.token().boolean();
+}
+
+template <typename CharT>
+utils::ErrorCode BasicLazyValue<CharT>::error() const {
+  if (IsMissing() || IsObject() || IsArray()) {
+    return utils::ErrorCode::kNone;
+  }
+
+  token::CompactTokenizer<CharT> tokenizer{Letters()};
+  return Extract(tokenizer);
+}
+
+template <typename CharT>
+BasicValue<CharT> BasicLazyValue<CharT>::Materialize() const {
+  if (IsMissing()) {
+    return {};
+  }
+
+  const std::basic_string_view<CharT> text = document_->text_;
+  const token::StructuralIndex &index = document_->index_;
+  size_t last = Skip(position_);
+  const CharT *begin = text.data() + index[position_];
+  const CharT *end = text.data() + text.size();
+
+  // containers end with their closing bracket, scalars before the next token
+  if (IsObject() || IsArray()) {
+    end = text.data() + index[last - 1] + 1;
+  } else if (last < index.size()) {
+    end = text.data() + index[last];
+  }
+
+  token::CompactTokenizer<CharT> tokenizer{{begin, end}};
+  parser::Parser<CharT, token::CompactToken<CharT>> parser;
+
+  while (!tokenizer.Done() && parser.error() == utils::ErrorCode::kNone) {
+    tokenizer.Extract();
+    parser.take(tokenizer.token());
+  }
+
+  if (tokenizer.error() != utils::ErrorCode::kNone || !parser.done()) {
+    return {};
+  }
+
+  return parser.TakeRoot();
+}
+
+template <typename CharT>
+CharT BasicLazyValue<CharT>::Letter(size_t position) const {
+  return document_->text_[document_->index_[position]];
+}
+
+template <typename CharT>
+size_t BasicLazyValue<CharT>::Skip(size_t position) const {
+  using namespace utils;
+
+  const size_t size = document_->index_.size();
+  CharT letter = Letter(position);
+
+  if (letter != letters::kLeftCurleyBrace<CharT> &&
+      letter != letters::kLeftSquareBracket<CharT>) {
+    return position + 1;
+  }
+
+  size_t depth = 0;
+
+  for (; position < size; ++position) {
+    switch (Letter(position)) {
+      case letters::kLeftCurleyBrace<CharT>:
+      case letters::kLeftSquareBracket<CharT>:
+        ++depth;
+        break;
+      case letters::kRightCurleyBrace<CharT>:
+      case letters::kRightSquareBracket<CharT>:
+        if (--depth == 0) {
+          return position + 1;
+        }
+        break;
+      default:
+        break;
+    }
+  }
+
+  return size;
+}
+
+template <typename CharT>
+size_t BasicLazyValue<CharT>::Next(size_t position) const {
+  const size_t size = document_->index_.size();
+  position = Skip(position);
+
+  if (position < size && Letter(position) == utils::letters::kComma<CharT>) {
+    return position + 1;
+  }
+
+  // the end of the object or array is never a member or an element
+  return size;
+}
+
+template <typename CharT>
+std::basic_string_view<CharT> BasicLazyValue<CharT>::Letters() const {
+  const std::basic_string_view<CharT> text = document_->text_;
+  const token::StructuralIndex &index = document_->index_;
+  size_t begin = index[position_];
+  size_t end = position_ + 1 < index.size() ? index[position_ + 1]
+                                             : text.size();
+
+  return text.substr(begin, end - begin);
+}
+
+template <typename CharT>
+utils::ErrorCode BasicLazyValue<CharT>::Extract(
+    token::CompactTokenizer<CharT> &tokenizer) const {
+  using TType = typename token::CompactToken<CharT>::Type;
+
+  tokenizer.Extract();
+
+  if (tokenizer.error() != utils::ErrorCode::kNone) {
+    return tokenizer.error();
+  }
+
+  // the letters up to the next token hold one value, `12x` is not a number;
+  // the rest is read by another tokenizer, so the token stays valid
+  token::CompactTokenizer<CharT> rest{Letters().substr(tokenizer.offset())};
+  rest.Extract();
+
+  if (rest.error() != utils::ErrorCode::kNone) {
+    return rest.error();
+  }
+
+  return rest.token().type == TType::kUninitialized
+             ? utils::ErrorCode::kNone
+             : utils::ErrorCode::kUnexpectedToken;
+}
+
+template <typename CharT>
+BasicLazyDocument<CharT>::BasicLazyDocument(
+    std::basic_string_view<CharT> text)
+    : text_(text) {
+  // a text that is too large leaves the index empty, so the root is missing
+  index_.Build(text.data(), text.data() + text.size());
+}
+
+template <typename CharT>
+BasicLazyValue<CharT> BasicLazyDocument<CharT>::root() const {
+  return {this, index_.size() == 0 ? BasicLazyValue<CharT>::kMissing : 0};
+}
+
+template <typename CharT>
+BasicLazyValue<CharT> BasicLazyDocument<CharT>::operator[](
+    typename BasicLazyValue<CharT>::Key key) const {
+  return root()[key];
+}
+
+template <typename CharT>
+BasicLazyValue<CharT> BasicLazyDocument<CharT>::operator[](
+    size_t index) const {
+  return root()[index];
+}
+
+template <typename CharT>
+bool BasicLazyDocument<CharT>::Contains(
+    typename BasicLazyValue<CharT>::Key key) const {
+  return root().Contains(key);
+}
+}  // namespace json
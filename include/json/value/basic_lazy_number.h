@@ -0,0 +1,139 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <string_view>
+#include <thread>
+#include "json/utils/convert.h"
+
+namespace json {
+/**
+ * @brief A number that keeps its letters and converts them the first time
+ * the value is read, the converted value is cached
+ *
+ * The number does not own the letters, the storage that provides them must
+ * outlive the number. Like the other const methods of the library, `value`
+ * can be called from several threads at once: the letters are converted by
+ * one of them while the others wait for the value.
+ */
+template <typename CharT>
+class BasicLazyNumber {
+ public:
+  /**
+   * @brief Type used to store the letters of the number
+   */
+  using Text = std::basic_string_view<CharT>;
+
+  /**
+   * @brief Create a number from its letters
+   * @param text the letters of a json number
+   */
+  explicit BasicLazyNumber(Text text);
+
+  /**
+   * @brief Copy a number, with its value if it was converted already
+   */
+  BasicLazyNumber(const BasicLazyNumber &other);
+
+  BasicLazyNumber &operator=(const BasicLazyNumber &other);
+
+  /**
+   * @brief Get the letters of the number, as they appear in the input
+   * @returns the letters
+   */
+  Text text() const;
+
+  /**
+   * @brief Get the value of the number
+   * @returns a reference to the converted value
+   */
+  const utils::convert::number::Value &value() const;
+
+  /**
+   * @brief Determine if two numbers have the same letters
+   * @returns `true` if equal, false otherwise
+   */
+  bool operator==(const BasicLazyNumber<CharT> &other) const;
+
+ private:
+  enum class State : uint8_t {
+    kEmpty,
+    kConverting,
+    kReady,
+  };
+
+  Text text_;
+  mutable std::atomic<State> state_{State::kEmpty};
+  mutable utils::convert::number::Value value_;
+};
+}  // namespace json
+
+// Implementations
+
+namespace json {
+template <typename CharT>
+BasicLazyNumber<CharT>::BasicLazyNumber(Text text) : text_(text) {}
+
+template <typename CharT>
+BasicLazyNumber<CharT>::BasicLazyNumber(const BasicLazyNumber &other)
+    : text_(other.text_) {
+  if (other.state_.load(std::memory_order_acquire) == State::kReady) {
+    value_ = other.value_;
+    state_.store(State::kReady, std::memory_order_relaxed);
+  }
+}
+
+template <typename CharT>
+BasicLazyNumber<CharT> &BasicLazyNumber<CharT>::operator=(
+    const BasicLazyNumber &other) {
+  if (this == &other) {
+    return *this;
+  }
+
+  text_ = other.text_;
+
+  if (other.state_.load(std::memory_order_acquire) == State::kReady) {
+    value_ = other.value_;
+    state_.store(State::kReady, std::memory_order_relaxed);
+  } else {
+    state_.store(State::kEmpty, std::memory_order_relaxed);
+  }
+
+  return *this;
+}
+
+template <typename CharT>
+typename BasicLazyNumber<CharT>::Text BasicLazyNumber<CharT>::text() const {
+  return text_;
+}
+
+template <typename CharT>
+const utils::convert::number::Value &BasicLazyNumber<CharT>::value() const {
+  using namespace utils::convert;
+
+  if (state_.load(std::memory_order_acquire) == State::kReady) {
+    return value_;
+  }
+
+  State expected = State::kEmpty;
+
+  if (state_.compare_exchange_strong(expected, State::kConverting,
+                                     std::memory_order_acquire)) {
+    value_ = number::Parse(text_.data(), text_.data() + text_.size());
+    state_.store(State::kReady, std::memory_order_release);
+  } else {
+    // another thread is converting the letters, which does not take long
+    while (state_.load(std::memory_order_acquire) != State::kReady) {
+      std::this_thread::yield();
+    }
+  }
+
+  return value_;
+}
+
+template <typename CharT>
+bool BasicLazyNumber<CharT>::operator==(
+    const BasicLazyNumber<CharT> &other) const {
+  return text_ == other.text_;
+}
+}  // namespace json
@@ -8,14 +8,19 @@
 
 #pragma once
 
+#include <stdint.h>
 #include <iostream>
 #include <iterator>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <unordered_map>
 #include <utility>
 #include <variant>
 #include <vector>
+#include "json/utils/convert.h"
 #include "json/value/basic_key.h"
+#include "json/value/basic_lazy_number.h"
 
 namespace json {
 /**
@@ -69,6 +74,23 @@ class BasicValue {
    */
   using Number = double;
 
+  /**
+   * @brief Type used to store an integer number
+   */
+  using Integer = int64_t;
+
+  /**
+   * @brief Type used to store an integer number larger than the largest
+   * `Integer`
+   */
+  using Unsigned = uint64_t;
+
+  /**
+   * @brief Type used to store a number whose letters are converted the first
+   * time the value is read
+   */
+  using LazyNumber = BasicLazyNumber<CharT>;
+
   /**
    * @brief Type used to store a boolean
    */
@@ -90,9 +112,11 @@ class BasicValue {
   using Array = std::vector<BasicValue<CharT>>;
 
   /**
-   * @brief Type used to store the data of the json value
+   * @brief Type used to store the data of the json value, the integer and
+   * lazy alternatives are of type `Type::kNumber`
    */
-  using Data = std::variant<Null, Number, Boolean, String, Object, Array>;
+  using Data = std::variant<Null, Number, Boolean, String, Object, Array,
+                            Integer, Unsigned, LazyNumber>;
 
   /**
    * @brief Create a null value
@@ -123,12 +147,34 @@ class BasicValue {
    */
   BasicValue(String &&str);
 
+  /**
+   * @brief Construct a string value
+   * @param str a view of the letters to copy
+   */
+  explicit BasicValue(std::basic_string_view<CharT> str);
+
   /**
    * @brief Construct a number value
    * @param number the number the json value would hold
    */
   BasicValue(const double &number);
 
+  /**
+   * @brief Construct an integer number value
+   * @param integer the number the json value would hold, signed integers are
+   * stored as `Integer` and unsigned integers as `Unsigned`
+   */
+  template <typename IntT, typename = std::enable_if_t<
+                               std::is_integral_v<IntT> &&
+                               !std::is_same_v<IntT, bool>>>
+  BasicValue(IntT integer);
+
+  /**
+   * @brief Construct a lazy number value
+   * @param number the letters of the number, referenced by the value
+   */
+  BasicValue(const LazyNumber &number);
+
   /**
    * @brief Construct a boolean value
    * @param boolean the number the json value would hold
@@ -207,6 +253,17 @@ class BasicValue {
    */
   void Set(const Key &key, BasicValue<CharT> &value);
 
+  /**
+   * @brief Set the a value using the key, moving both into the object
+   *
+   * if a value associated with the key already exits,
+   * override the existing value.
+   *
+   * @param value the value
+   * @param key the key used to set the value
+   */
+  void Set(Key &&key, BasicValue<CharT> &&value);
+
   /**
    * @brief Erase the value with the key
    * @param key the key associated with the value
@@ -261,6 +318,14 @@ class BasicValue {
    */
   void Append(BasicValue<CharT> &&value);
 
+  /**
+   * @brief Move the elements of another array to the end of the array, or
+   * the members of another object into the object, overriding the values of
+   * existing keys
+   * @param other a value of the same type, left empty
+   */
+  void Merge(BasicValue<CharT> &&other);
+
   /**
    * @brief Erase element in the array, will push elements to remain ordering.
    * @param index the index to erase at.
@@ -319,18 +384,51 @@ class BasicValue {
   void set_number(const Number &number);
 
   /**
-   * @brief Retrieve a reference to the number represented by the
-   * primitive
-   * @returns a constant reference to the number.
+   * @brief Retrieve the number represented by the primitive, integers are
+   * converted to double
+   * @returns the number.
    */
-  Number &number();
+  Number number() const;
 
   /**
-   * @brief Retrieve a constant reference to the number represented by the
-   * primitive
-   * @returns a constant reference to the number.
+   * @brief Determines if the number is stored as a 64 bit integer
+   * @returns true if the number is an integer
+   */
+  bool IsInteger() const;
+
+  /**
+   * @brief Set the value of the primitive to an integer number
+   * @param integer the value to use
    */
-  const Number &number() const;
+  void set_int64(const Integer &integer);
+
+  /**
+   * @brief Retrieve the number represented by the primitive as a signed
+   * integer, doubles are truncated and numbers out of range are clamped
+   * @returns the number.
+   */
+  Integer int64() const;
+
+  /**
+   * @brief Set the value of the primitive to an unsigned integer number
+   * @param integer the value to use
+   */
+  void set_uint64(const Unsigned &integer);
+
+  /**
+   * @brief Retrieve the number represented by the primitive as an unsigned
+   * integer, doubles are truncated and numbers out of range, negative ones
+   * included, are clamped
+   * @returns the number.
+   */
+  Unsigned uint64() const;
+
+  /**
+   * @brief Retrieve a constant reference to the lazy number represented by
+   * the primitive, to access the letters of the number
+   * @returns a constant reference to the lazy number.
+   */
+  const LazyNumber &lazy_number() const;
 
   /**
    * @brief Set the value of the primitive to a boolean
@@ -421,11 +519,31 @@ BasicValue<CharT>::BasicValue(String &&str) {
   data_.template emplace<String>(std::move(str));
 }
 
+template <typename CharT>
+BasicValue<CharT>::BasicValue(std::basic_string_view<CharT> str) {
+  data_.template emplace<String>(str);
+}
+
 template <typename CharT>
 BasicValue<CharT>::BasicValue(const double &number) {
   data_.template emplace<Number>(number);
 }
 
+template <typename CharT>
+template <typename IntT, typename>
+BasicValue<CharT>::BasicValue(IntT integer) {
+  if constexpr (std::is_signed_v<IntT>) {
+    data_.template emplace<Integer>(integer);
+  } else {
+    data_.template emplace<Unsigned>(integer);
+  }
+}
+
+template <typename CharT>
+BasicValue<CharT>::BasicValue(const LazyNumber &number) {
+  data_.template emplace<LazyNumber>(number);
+}
+
 template <typename CharT>
 BasicValue<CharT>::BasicValue(const bool &boolean) {
   data_.template emplace<Boolean>(boolean);
@@ -444,7 +562,14 @@ BasicValue<CharT>::~BasicValue() {}
 
 template <typename CharT>
 typename BasicValue<CharT>::Type BasicValue<CharT>::type() const {
-  return static_cast<Type>(data_.index());
+  switch (data_.index()) {
+    case 6:
+    case 7:
+    case 8:
+      return Type::kNumber;
+    default:
+      return static_cast<Type>(data_.index());
+  }
 }
 
 template <typename CharT>
@@ -503,6 +628,12 @@ void BasicValue<CharT>::Set(const Key &key, BasicValue<CharT> &value) {
   data.insert_or_assign(key, value);
 }
 
+template <typename CharT>
+void BasicValue<CharT>::Set(Key &&key, BasicValue<CharT> &&value) {
+  Object &data = std::get<Object>(data_);
+  data.insert_or_assign(std::move(key), std::move(value));
+}
+
 template <typename CharT>
 void BasicValue<CharT>::Erase(const Key &key) {
   Object &data = std::get<Object>(data_);
@@ -553,6 +684,28 @@ void BasicValue<CharT>::Append(BasicValue<CharT> &&value) {
   data.push_back(std::move(value));
 }
 
+template <typename CharT>
+void BasicValue<CharT>::Merge(BasicValue<CharT> &&other) {
+  if (IsArray()) {
+    Array &data = std::get<Array>(data_);
+    Array &elements = std::get<Array>(other.data_);
+
+    data.insert(data.end(), std::make_move_iterator(elements.begin()),
+                std::make_move_iterator(elements.end()));
+    elements.clear();
+    return;
+  }
+
+  Object &data = std::get<Object>(data_);
+  Object &members = std::get<Object>(other.data_);
+
+  for (auto &member : members) {
+    data.insert_or_assign(member.first, std::move(member.second));
+  }
+
+  members.clear();
+}
+
 template <typename CharT>
 void BasicValue<CharT>::Erase(const size_t index) {
   Array &data = std::get<Array>(data_);
@@ -564,7 +717,7 @@ void BasicValue<CharT>::Erase(const size_t index) {
 
 template <typename CharT>
 const BasicValue<CharT> &BasicValue<CharT>::operator[](size_t index) const {
-  Array &data = std::get<Array>(data_);
+  const Array &data = std::get<Array>(data_);
   return data[index];
 }
 
@@ -605,13 +758,79 @@ void BasicValue<CharT>::set_number(const Number &number) {
 }
 
 template <typename CharT>
-typename BasicValue<CharT>::Number &BasicValue<CharT>::number() {
-  return std::get<Number>(data_);
+typename BasicValue<CharT>::Number BasicValue<CharT>::number() const {
+  switch (data_.index()) {
+    case 6:
+      return Number(std::get<Integer>(data_));
+    case 7:
+      return Number(std::get<Unsigned>(data_));
+    case 8:
+      return std::visit([](auto value) { return Number(value); },
+                        std::get<LazyNumber>(data_).value());
+    default:
+      return std::get<Number>(data_);
+  }
+}
+
+template <typename CharT>
+bool BasicValue<CharT>::IsInteger() const {
+  if (data_.index() == 8) {
+    return std::get<LazyNumber>(data_).value().index() != 0;
+  }
+
+  return data_.index() == 6 || data_.index() == 7;
+}
+
+template <typename CharT>
+void BasicValue<CharT>::set_int64(const Integer &integer) {
+  data_.template emplace<Integer>(integer);
+}
+
+template <typename CharT>
+typename BasicValue<CharT>::Integer BasicValue<CharT>::int64() const {
+  using utils::convert::number::ToInteger;
+
+  const auto convert = [](auto value) { return ToInteger<Integer>(value); };
+
+  switch (data_.index()) {
+    case 6:
+      return std::get<Integer>(data_);
+    case 7:
+      return convert(std::get<Unsigned>(data_));
+    case 8:
+      return std::visit(convert, std::get<LazyNumber>(data_).value());
+    default:
+      return convert(std::get<Number>(data_));
+  }
+}
+
+template <typename CharT>
+void BasicValue<CharT>::set_uint64(const Unsigned &integer) {
+  data_.template emplace<Unsigned>(integer);
+}
+
+template <typename CharT>
+typename BasicValue<CharT>::Unsigned BasicValue<CharT>::uint64() const {
+  using utils::convert::number::ToInteger;
+
+  const auto convert = [](auto value) { return ToInteger<Unsigned>(value); };
+
+  switch (data_.index()) {
+    case 6:
+      return convert(std::get<Integer>(data_));
+    case 7:
+      return std::get<Unsigned>(data_);
+    case 8:
+      return std::visit(convert, std::get<LazyNumber>(data_).value());
+    default:
+      return convert(std::get<Number>(data_));
+  }
 }
 
 template <typename CharT>
-const typename BasicValue<CharT>::Number &BasicValue<CharT>::number() const {
-  return std::get<Number>(data_);
+const typename BasicValue<CharT>::LazyNumber &BasicValue<CharT>::lazy_number()
+    const {
+  return std::get<LazyNumber>(data_);
 }
 
 template <typename CharT>
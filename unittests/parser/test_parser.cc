@@ -1,8 +1,19 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <fstream>
 #include <iterator>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
 #include <string_view>
+#include <thread>
+#include <variant>
+#include <vector>
 #include "gtest/gtest.h"
 #include "json/json.h"
+#include "json/token/push_tokenizer.h"
 
 using std::string_view;
 using namespace json;
@@ -15,6 +26,30 @@ TEST(ParserTest, Primitive) {
   EXPECT_FLOAT_EQ(value.number(), 123.0);
 }
 
+TEST(ParserTest, Integer) {
+  string_view json = "{ \"id\": 9007199254740993, \"ratio\": 0.5 }";
+  Value value = json::parse(json);
+
+  ASSERT_TRUE(value["id"].IsInteger());
+  EXPECT_EQ(value["id"].int64(), 9007199254740993);
+  EXPECT_FALSE(value["ratio"].IsInteger());
+  EXPECT_EQ(value["ratio"].number(), 0.5);
+}
+
+TEST(ParserTest, LazyNumber) {
+  string_view json = "{ \"id\": 9007199254740993, \"ratio\": 1e-2 }";
+  Value value = json::parse(json, {/* lazy_numbers */ true});
+
+  ASSERT_EQ(value["id"].type(), Value::Type::kNumber);
+  ASSERT_TRUE(value["id"].IsInteger());
+  EXPECT_EQ(value["id"].int64(), 9007199254740993);
+  EXPECT_EQ(value["id"].lazy_number().text(), "9007199254740993");
+
+  EXPECT_FALSE(value["ratio"].IsInteger());
+  EXPECT_EQ(value["ratio"].number(), 0.01);
+  EXPECT_EQ(value["ratio"].lazy_number().text(), "1e-2");
+}
+
 TEST(ParserTest, Object) {
   string_view json = "{ \"a\": \"b\", \"c\": \"d\", \"e\": { \"f\": \"g\" } }";
   Value value = json::parse(json);
@@ -51,6 +86,193 @@ TEST(ParserTest, Array) {
   EXPECT_FLOAT_EQ(nested[1].number(), 223.0);
 }
 
+TEST(ParserTest, PointerRange) {
+  const char json[] = "{ \"a\": [1, 2] }trailing";
+  const char *end = json + string_view{json}.find("trailing");
+  Value value = json::parse(json, end);
+
+  ASSERT_EQ(value.type(), Value::Type::kObject);
+  ASSERT_TRUE(value.Contains("a"));
+  ASSERT_EQ(value["a"].size(), size_t{2});
+  EXPECT_FLOAT_EQ(value["a"][1].number(), 2.0);
+}
+
+TEST(ParserTest, Push) {
+  string_view json = "{ \"a\": [1, 2.5, \"text\"], \"b\": null }";
+  parser::Parser<char> parser;
+  token::PushTokenizer<char, parser::Parser<char>> tokenizer{parser};
+
+  // feed the parser while the input arrives in chunks of 3 letters
+  for (size_t i = 0; i < json.size(); i += 3) {
+    string_view chunk = json.substr(i, 3);
+    ASSERT_TRUE(tokenizer.Feed(chunk.data(), chunk.size()));
+  }
+
+  ASSERT_TRUE(tokenizer.Finish());
+
+  Value value = parser.root();
+
+  ASSERT_EQ(value.type(), Value::Type::kObject);
+  ASSERT_EQ(value["a"].size(), size_t{3});
+  EXPECT_EQ(value["a"][1].number(), 2.5);
+  EXPECT_EQ(value["a"][2].string(), "text");
+  EXPECT_EQ(value["b"].type(), Value::Type::kNull);
+}
+
+TEST(ParserTest, TakeRootReset) {
+  parser::Parser<char> parser;
+
+  for (string_view json : {"{\"a\": [1, 2]}", "[\"b\", {\"c\": true}]"}) {
+    token::BufferTokenizer<char> tokenizer{json};
+    parser.Reset();
+
+    while (!tokenizer.Done()) {
+      tokenizer.Extract();
+      parser.take(tokenizer.token());
+    }
+
+    ASSERT_TRUE(parser.done());
+    ASSERT_EQ(parser.error(), utils::ErrorCode::kNone);
+
+    Value value = parser.TakeRoot();
+    EXPECT_EQ(value.size(), json[0] == '{' ? size_t{1} : size_t{2});
+  }
+
+  // a reset parser takes a value after an error
+  token::Token<char> token;
+  token.type = token::Token<char>::Type::kEndArray;
+  parser.Reset();
+  parser.take(token);
+  EXPECT_EQ(parser.error(), utils::ErrorCode::kUnexpectedToken);
+
+  parser.Reset();
+  token.type = token::Token<char>::Type::kNull;
+  parser.take(token);
+  EXPECT_TRUE(parser.done());
+  EXPECT_EQ(parser.TakeRoot().type(), Value::Type::kNull);
+}
+
+TEST(ParserTest, Comment) {
+  string_view json = "{\n  // the values\n  \"a\": [1, /* two */ 2]\n}";
+  token::Options options;
+  options.comments = true;
+  options.comment_tokens = true;
+
+  Value value = parse(json, options);
+
+  ASSERT_EQ(value.type(), Value::Type::kObject);
+  ASSERT_EQ(value["a"].size(), size_t{2});
+  EXPECT_EQ(value["a"][1].number(), 2.0);
+}
+
+TEST(ParserTest, Tape) {
+  string_view json =
+      "{ \"a\": [1, 2.5, \"t\\u0041\"], \"b\": {}, \"c\": null }";
+  parser::Tape<char> tape;
+
+  ASSERT_TRUE(tape.Build(json.data(), json.data() + json.size()));
+
+  Value value = parse(tape);
+
+  ASSERT_EQ(value.type(), Value::Type::kObject);
+  ASSERT_EQ(value["a"].size(), size_t{3});
+  EXPECT_EQ(value["a"][0].int64(), 1);
+  EXPECT_EQ(value["a"][1].number(), 2.5);
+  EXPECT_EQ(value["a"][2].string(), "tA");
+  EXPECT_EQ(value["b"].type(), Value::Type::kObject);
+  EXPECT_EQ(value["c"].type(), Value::Type::kNull);
+
+  // a tape that failed to build is empty and never walked
+  for (string_view invalid : {"{\"a\"}", "[1,,]", "{\"a\": [1"}) {
+    EXPECT_FALSE(tape.Build(invalid.data(), invalid.data() + invalid.size()))
+        << invalid;
+    EXPECT_EQ(parse(tape).type(), Value::Type::kNull) << invalid;
+  }
+}
+
+TEST(ParserTest, TryParse) {
+  auto result = try_parse(string_view{"{ \"a\": [1, true] }"});
+
+  ASSERT_TRUE(result.is_ok());
+  EXPECT_EQ(result.result()["a"].size(), size_t{2});
+
+  struct Case {
+    string_view json;
+    utils::ErrorCode code;
+    size_t offset;
+  };
+
+  for (const Case &c : {
+           Case{"[1, x]", utils::ErrorCode::kUnexpectedLetter, 4},
+           Case{"[1 2]", utils::ErrorCode::kUnexpectedToken, 4},
+           Case{"{\"a\" 1}", utils::ErrorCode::kUnexpectedToken, 6},
+           Case{"[1,", utils::ErrorCode::kUnexpectedEnd, 3},
+           Case{"\"abc", utils::ErrorCode::kUnexpectedEnd, 4},
+           Case{"  ", utils::ErrorCode::kUnexpectedEnd, 2},
+           Case{"{} []", utils::ErrorCode::kUnexpectedToken, 4},
+           Case{"[tru]", utils::ErrorCode::kInvalidLiteral, 1},
+           Case{"1.", utils::ErrorCode::kInvalidNumber, 0},
+           Case{"01", utils::ErrorCode::kInvalidNumber, 0},
+           Case{"-", utils::ErrorCode::kInvalidNumber, 0},
+           Case{"1e", utils::ErrorCode::kInvalidNumber, 0},
+           Case{"[1, -.5]", utils::ErrorCode::kInvalidNumber, 4},
+       }) {
+    auto error = try_parse(c.json);
+
+    ASSERT_TRUE(error.is_error()) << c.json;
+    EXPECT_EQ(error.error().code, c.code) << c.json;
+    EXPECT_EQ(error.error().offset, c.offset) << c.json;
+
+    std::stringstream stream{std::string{c.json}};
+    auto streamed = try_parse(stream);
+
+    ASSERT_TRUE(streamed.is_error()) << c.json;
+    EXPECT_EQ(streamed.error().code, c.code) << c.json;
+  }
+}
+
+TEST(ParserTest, TryParseFailFast) {
+  // the error is found without reading the rest of the input
+  std::string json = "[1, ?";
+  json.append(1 << 20, ' ');
+  json += "]";
+
+  auto result = try_parse(string_view{json});
+
+  ASSERT_TRUE(result.is_error());
+  EXPECT_EQ(result.error().offset, size_t{4});
+  EXPECT_STREQ(result.error().what(), "unexpected letter");
+}
+
+TEST(ParserTest, ErrorPosition) {
+  string_view json = "{\n  \"a\": 1,\n  \"b\": ]\n}";
+  auto result = try_parse(json);
+
+  ASSERT_TRUE(result.is_error());
+
+  ParseError::Position position = result.error().Locate(json);
+
+  EXPECT_EQ(position.line, size_t{3});
+  EXPECT_EQ(position.column, size_t{9});
+}
+
+TEST(ParserTest, Utf8ToWide) {
+  string_view json =
+      "{ \"caf\xc3\xa9\": [\"\\ud83d\\ude00 \xe2\x82\xac\", 1.5, true] }";
+
+  BasicValue<char16_t> utf16 = parse_utf8<char16_t>(json);
+
+  ASSERT_TRUE(utf16.Contains(u"caf\u00e9"));
+  EXPECT_EQ(utf16[u"caf\u00e9"][0].string(), u"\U0001F600 \u20ac");
+  EXPECT_EQ(utf16[u"caf\u00e9"][1].number(), 1.5);
+  EXPECT_TRUE(utf16[u"caf\u00e9"][2].boolean());
+
+  BasicValue<char32_t> utf32 = parse_utf8<char32_t>(json);
+
+  ASSERT_TRUE(utf32.Contains(U"caf\u00e9"));
+  EXPECT_EQ(utf32[U"caf\u00e9"][0].string(), U"\U0001F600 \u20ac");
+}
+
 TEST(ParserTest, File) {
   std::ifstream file{"../unittests/resources/1.jsonc"};
 
@@ -74,4 +296,459 @@ TEST(ParserTest, File) {
 
   ASSERT_TRUE(deathEffect.Contains("Rock"));
   EXPECT_FLOAT_EQ(deathEffect["Rock"].number(), 3);
-}
\ No newline at end of file
+}
+
+TEST(ParserTest, MappedFile) {
+  Value value = json::parse_file("../unittests/resources/1.jsonc");
+
+  ASSERT_EQ(value.type(), Value::Type::kArray);
+
+  const Value &last = value[value.size() - 1];
+  ASSERT_TRUE(last.Contains("Type"));
+  EXPECT_EQ(last["Type"].string(), "Monster");
+
+  std::ifstream file{"../unittests/resources/1.jsonc"};
+  EXPECT_EQ(value.size(), json::parse(file).size());
+
+  EXPECT_EQ(json::parse_file("missing.json").type(), Value::Type::kNull);
+}
+
+TEST(ParserTest, Parallel) {
+  // strings hold escaped quotes, brackets and separators so that the chunks
+  // are cut inside of them
+  std::string text = "[";
+
+  for (size_t i = 0; i < 20000; ++i) {
+    if (i != 0) {
+      text += ",\n";
+    }
+
+    text += "{\"id\": " + std::to_string(i) +
+            ", \"name\": \"a \\\"[quoted]\\\", {name}\\\\\", \"tags\": [1, "
+            "[2, {\"k\": null}], true]}";
+  }
+
+  text += "]";
+
+  utils::ThreadPool pool{4};
+  Value serial = json::parse(string_view{text});
+  Value parallel = json::parse_parallel(string_view{text}, pool);
+
+  ASSERT_EQ(parallel.type(), Value::Type::kArray);
+  ASSERT_EQ(parallel.size(), serial.size());
+
+  for (size_t i = 0; i < parallel.size(); i += 997) {
+    const Value &element = parallel[i];
+
+    ASSERT_EQ(element.type(), Value::Type::kObject);
+    EXPECT_FLOAT_EQ(element["id"].number(), float(i));
+    EXPECT_EQ(element["name"].string(), serial[i]["name"].string());
+    EXPECT_EQ(element["name"].string(), "a \"[quoted]\", {name}\\");
+    ASSERT_EQ(element["tags"].size(), size_t{3});
+    EXPECT_EQ(element["tags"][1][1]["k"].type(), Value::Type::kNull);
+  }
+
+  EXPECT_FLOAT_EQ(parallel[parallel.size() - 1]["id"].number(), 19999);
+}
+
+TEST(ParserTest, ParallelObject) {
+  std::string text = "{";
+
+  for (size_t i = 0; i < 20000; ++i) {
+    if (i != 0) {
+      text += ", ";
+    }
+
+    text += "\"key " + std::to_string(i) + "\": [\"}, \\\"" +
+            std::to_string(i) + "\"]";
+  }
+
+  text += "}";
+
+  utils::ThreadPool pool{4};
+  Value value = json::parse_parallel(string_view{text}, pool);
+
+  ASSERT_EQ(value.type(), Value::Type::kObject);
+  EXPECT_EQ(value.size(), size_t{20000});
+  EXPECT_EQ(value["key 0"][0].string(), "}, \"0");
+  EXPECT_EQ(value["key 19999"][0].string(), "}, \"19999");
+}
+
+TEST(ParserTest, ParallelInvalid) {
+  std::string text = "[";
+
+  for (size_t i = 0; i < 40000; ++i) {
+    text += "\"element\", ";
+  }
+
+  // a missing element is only seen by one of the parts, the text is then
+  // parsed on the calling thread like `parse` does
+  text += ", 1]";
+
+  utils::ThreadPool pool{4};
+  Value value = json::parse_parallel(string_view{text}, pool);
+
+  EXPECT_EQ(value.type(), json::parse(string_view{text}).type());
+
+  // small texts and values that are not containers are parsed serially
+  EXPECT_FLOAT_EQ(json::parse_parallel(string_view{"12"}, pool).number(), 12);
+  EXPECT_EQ(json::parse_parallel(string_view{"[1, 2]"}, pool).size(),
+            size_t{2});
+}
+
+TEST(ParserTest, ParallelTaskGroup) {
+  utils::ThreadPool pool{2};
+  std::atomic<bool> finished{false};
+
+  // the group waits for every task before the exception of one is thrown
+  {
+    parser::detail::TaskGroup<int> group{pool};
+
+    group.Submit([]() -> int { throw std::runtime_error{"task"}; });
+    group.Submit([&finished]() {
+      std::this_thread::sleep_for(std::chrono::milliseconds{50});
+      finished = true;
+      return 1;
+    });
+
+    EXPECT_THROW(group.Get(), std::runtime_error);
+    EXPECT_TRUE(finished);
+  }
+}
+
+TEST(ParserTest, Lines) {
+  std::string text;
+
+  for (size_t i = 0; i < 10000; ++i) {
+    text += "{\"id\": " + std::to_string(i) + ", \"tags\": [\"a\\nb\"]}\n";
+
+    if (i % 100 == 0) {
+      text += "  \r\n";
+    }
+  }
+
+  utils::ThreadPool pool{4};
+  parser::LinesOptions options;
+  options.batch = 4096;
+
+  std::vector<size_t> ids;
+  parser::LinesReport report =
+      json::parse_lines(string_view{text}, pool,
+                        [&ids](Value &&value) {
+                          ids.push_back(size_t(value["id"].number()));
+                        },
+                        options);
+
+  EXPECT_EQ(report.records, size_t{10000});
+  EXPECT_EQ(report.malformed, size_t{0});
+  EXPECT_EQ(report.error.code, utils::ErrorCode::kNone);
+  ASSERT_EQ(ids.size(), size_t{10000});
+
+  for (size_t i = 0; i < ids.size(); ++i) {
+    ASSERT_EQ(ids[i], i);
+  }
+
+  // unordered values are all handed over, in any order
+  options.ordered = false;
+  ids.clear();
+  report = json::parse_lines(
+      string_view{text}, pool,
+      [&ids](Value &&value) { ids.push_back(size_t(value["id"].number())); },
+      options);
+
+  EXPECT_EQ(report.records, size_t{10000});
+  std::sort(ids.begin(), ids.end());
+  EXPECT_EQ(ids.back(), size_t{9999});
+  EXPECT_EQ(std::unique(ids.begin(), ids.end()), ids.end());
+}
+
+TEST(ParserTest, LinesMalformed) {
+  std::string text;
+
+  for (size_t i = 0; i < 3000; ++i) {
+    text += i % 1000 == 999 ? "{\"id\": }\n" : "[" + std::to_string(i) + "]\n";
+  }
+
+  utils::ThreadPool pool{2};
+  parser::LinesOptions options;
+  options.batch = 512;
+  options.skip_malformed = true;
+
+  size_t count = 0;
+  parser::LinesReport report = json::parse_lines(
+      string_view{text}, pool, [&count](Value &&) { ++count; }, options);
+
+  EXPECT_EQ(report.records, size_t{2997});
+  EXPECT_EQ(report.malformed, size_t{3});
+  EXPECT_EQ(count, report.records);
+
+  // without skipping, the first malformed line stops the reading
+  options.skip_malformed = false;
+  count = 0;
+  report = json::parse_lines(
+      string_view{text}, pool, [&count](Value &&) { ++count; }, options);
+
+  EXPECT_EQ(report.records, size_t{999});
+  EXPECT_EQ(count, size_t{999});
+  EXPECT_EQ(report.error.code, utils::ErrorCode::kUnexpectedToken);
+  EXPECT_EQ(report.error.Locate(string_view{text}).line, size_t{1000});
+}
+
+TEST(ParserTest, LinesThrow) {
+  std::string text;
+
+  for (size_t i = 0; i < 5000; ++i) {
+    text += "[" + std::to_string(i) + "]\n";
+  }
+
+  utils::ThreadPool pool{4};
+  parser::LinesOptions options;
+  options.batch = 64;
+
+  // the exception leaves only once the tasks in flight are done
+  for (bool ordered : {true, false}) {
+    options.ordered = ordered;
+    size_t count = 0;
+
+    EXPECT_THROW(json::parse_lines(string_view{text}, pool,
+                                   [&count](Value &&) {
+                                     if (++count == 100) {
+                                       throw std::runtime_error{"callback"};
+                                     }
+                                   },
+                                   options),
+                 std::runtime_error);
+    EXPECT_EQ(count, size_t{100});
+  }
+
+  // the pool is still usable
+  size_t count = 0;
+  parser::LinesReport report = json::parse_lines(
+      string_view{text}, pool, [&count](Value &&) { ++count; }, options);
+
+  EXPECT_EQ(report.records, size_t{5000});
+  EXPECT_EQ(count, size_t{5000});
+}
+
+TEST(ParserTest, LinesQueue) {
+  std::string text;
+
+  for (size_t i = 0; i < 5000; ++i) {
+    text += "\"line " + std::to_string(i) + "\"\n";
+  }
+
+  utils::ThreadPool pool{2};
+  utils::BoundedQueue<Value> queue{16};
+  parser::LinesOptions options;
+  options.batch = 1024;
+
+  std::thread producer{[&]() {
+    json::parse_lines(string_view{text}, pool, queue, options);
+  }};
+
+  size_t count = 0;
+
+  while (std::optional<Value> value = queue.Pop()) {
+    ASSERT_EQ(value->string(), "line " + std::to_string(count));
+    ++count;
+  }
+
+  producer.join();
+  EXPECT_EQ(count, size_t{5000});
+}
+
+TEST(ParserTest, DocumentStream) {
+  string_view json = "{\"a\": 1} [2, 3]\n\"four\" 5 true\x1enull \x1e{}";
+  auto documents = json::parse_documents(json);
+
+  std::vector<Value> values;
+
+  for (Value &value : documents) {
+    values.push_back(std::move(value));
+  }
+
+  EXPECT_EQ(documents.error().code, utils::ErrorCode::kNone);
+  ASSERT_EQ(values.size(), size_t{7});
+  EXPECT_FLOAT_EQ(values[0]["a"].number(), 1);
+  EXPECT_EQ(values[1].size(), size_t{2});
+  EXPECT_EQ(values[2].string(), "four");
+  EXPECT_FLOAT_EQ(values[3].number(), 5);
+  EXPECT_TRUE(values[4].boolean());
+  EXPECT_EQ(values[5].type(), Value::Type::kNull);
+  EXPECT_EQ(values[6].type(), Value::Type::kObject);
+}
+
+TEST(ParserTest, DocumentStreamIstream) {
+  std::stringstream stream{"\x1e[1]\n\x1e{\"b\": [true]}\n"};
+  auto documents = json::parse_documents(stream);
+
+  ASSERT_TRUE(documents.Next());
+  EXPECT_EQ(documents.value().size(), size_t{1});
+
+  ASSERT_TRUE(documents.Next());
+  EXPECT_TRUE(documents.value()["b"][0].boolean());
+
+  EXPECT_FALSE(documents.Next());
+  EXPECT_EQ(documents.error().code, utils::ErrorCode::kNone);
+}
+
+TEST(ParserTest, DocumentStreamError) {
+  string_view json = "[1] {\"a\": ] [2]";
+  auto documents = json::parse_documents(json);
+
+  ASSERT_TRUE(documents.Next());
+  EXPECT_FALSE(documents.Next());
+  EXPECT_EQ(documents.error().code, utils::ErrorCode::kUnexpectedToken);
+  EXPECT_EQ(documents.error().offset, size_t{11});
+
+  // the stream stays stopped after an error
+  EXPECT_FALSE(documents.Next());
+
+  auto truncated = json::parse_documents(string_view{"1 [2, "});
+
+  ASSERT_TRUE(truncated.Next());
+  EXPECT_FALSE(truncated.Next());
+  EXPECT_EQ(truncated.error().code, utils::ErrorCode::kUnexpectedEnd);
+}
+
+namespace {
+/**
+ * @brief Handler that writes the events it gets as letters
+ */
+struct EventWriter {
+  void StartObject() { events += "{"; }
+  void Key(string_view key) { events += std::string{key} + ":"; }
+  void EndObject() { events += "}"; }
+  void StartArray() { events += "["; }
+  void EndArray() { events += "]"; }
+  void String(string_view string) { events += "s" + std::string{string}; }
+
+  void Number(const parser::SaxNumber<char> &number) {
+    events += number.IsRaw() ? "r" : "n";
+    events += std::to_string(
+        std::visit([](auto value) { return double(value); }, number.value()));
+  }
+
+  void Bool(bool boolean) { events += boolean ? "t" : "f"; }
+  void Null() { events += "0"; }
+
+  std::string events;
+};
+}  // namespace
+
+TEST(ParserTest, Sax) {
+  string_view json = "{\"a\": [1.5, \"x\", true, null], \"b\": {}}";
+  EventWriter writer;
+
+  parser::ParseError error = json::parse_sax(json, writer);
+
+  EXPECT_EQ(error.code, utils::ErrorCode::kNone);
+  EXPECT_EQ(writer.events, "{a:[n1.500000sxt0]b:{}}");
+
+  // lazy numbers reach the handler as letters
+  token::Options options;
+  options.lazy_numbers = true;
+  writer.events.clear();
+
+  std::stringstream stream{"[2.5]"};
+  EXPECT_EQ(json::parse_sax(stream, writer).code, utils::ErrorCode::kNone);
+
+  EXPECT_EQ(json::parse_sax(string_view{"[2.5]"}, writer, options).code,
+            utils::ErrorCode::kNone);
+  EXPECT_EQ(writer.events, "[n2.500000][r2.500000]");
+}
+
+TEST(ParserTest, SaxGrammar) {
+  for (string_view json : {"[1,]", "{\"a\" 1}", "{1: 2}", "[1] 2", "[}"}) {
+    EventWriter writer;
+    EXPECT_EQ(json::parse_sax(json, writer).code,
+              utils::ErrorCode::kUnexpectedToken)
+        << json;
+  }
+
+  EventWriter writer;
+  EXPECT_EQ(json::parse_sax(string_view{"{\"a\": [1"}, writer).code,
+            utils::ErrorCode::kUnexpectedEnd);
+
+  // the sax parser can be fed by a push tokenizer
+  parser::SaxParser<char, EventWriter> sax{writer};
+  token::PushTokenizer<char, parser::SaxParser<char, EventWriter>> tokenizer{
+      sax};
+
+  writer.events.clear();
+  ASSERT_TRUE(tokenizer.Feed("[tr", 3));
+  ASSERT_TRUE(tokenizer.Feed("ue]", 3));
+  ASSERT_TRUE(tokenizer.Finish());
+  EXPECT_TRUE(sax.done());
+  EXPECT_EQ(writer.events, "[t]");
+}
+
+TEST(ParserTest, Reader) {
+  using Event = parser::ReaderEvent;
+
+  string_view json =
+      "{\"type\": \"point\", \"meta\": {\"tags\": [1, {\"a\": []}]}, "
+      "\"x\": 1.5, \"y\": -2, \"visible\": true, \"next\": null}";
+  parser::JsonReader<char> reader{json};
+
+  ASSERT_EQ(reader.Next(), Event::kStartObject);
+  EXPECT_EQ(reader.Depth(), size_t{1});
+
+  // read the discriminator first, then skip what is not needed
+  ASSERT_EQ(reader.Next(), Event::kKey);
+  EXPECT_EQ(reader.string(), "type");
+  EXPECT_EQ(reader.ReadString(), "point");
+
+  ASSERT_EQ(reader.Next(), Event::kKey);
+  EXPECT_EQ(reader.string(), "meta");
+  ASSERT_TRUE(reader.SkipValue());
+  EXPECT_EQ(reader.Depth(), size_t{1});
+
+  ASSERT_EQ(reader.Next(), Event::kKey);
+  EXPECT_EQ(std::get<double>(reader.ReadNumber()), 1.5);
+
+  ASSERT_EQ(reader.Next(), Event::kKey);
+  EXPECT_EQ(std::get<int64_t>(reader.ReadNumber()), -2);
+
+  ASSERT_EQ(reader.Next(), Event::kKey);
+  ASSERT_EQ(reader.Next(), Event::kBool);
+  EXPECT_TRUE(reader.boolean());
+
+  ASSERT_EQ(reader.Next(), Event::kKey);
+  ASSERT_TRUE(reader.SkipValue());
+
+  ASSERT_EQ(reader.Next(), Event::kEndObject);
+  EXPECT_EQ(reader.Depth(), size_t{0});
+  EXPECT_EQ(reader.Next(), Event::kEnd);
+  EXPECT_EQ(reader.error().code, utils::ErrorCode::kNone);
+}
+
+TEST(ParserTest, ReaderError) {
+  using Event = parser::ReaderEvent;
+
+  // the grammar of the parser is enforced, skipped values included
+  parser::JsonReader<char> reader{string_view{"[{\"a\": 1 2}, 3]"}};
+
+  ASSERT_EQ(reader.Next(), Event::kStartArray);
+  EXPECT_FALSE(reader.SkipValue());
+  EXPECT_EQ(reader.error().code, utils::ErrorCode::kUnexpectedToken);
+  EXPECT_EQ(reader.error().offset, size_t{10});
+  EXPECT_EQ(reader.Next(), Event::kError);
+
+  // reading a value of the wrong type is an error
+  std::stringstream stream{"{\"a\": \"text\"}"};
+  parser::IstreamJsonReader<char> typed{stream};
+
+  ASSERT_EQ(typed.Next(), Event::kStartObject);
+  ASSERT_EQ(typed.Next(), Event::kKey);
+  typed.ReadNumber();
+  EXPECT_EQ(typed.event(), Event::kError);
+  EXPECT_EQ(typed.error().code, utils::ErrorCode::kUnexpectedToken);
+
+  parser::JsonReader<char> truncated{string_view{"[1, "}};
+
+  ASSERT_EQ(truncated.Next(), Event::kStartArray);
+  ASSERT_EQ(truncated.Next(), Event::kNumber);
+  EXPECT_EQ(truncated.Next(), Event::kError);
+  EXPECT_EQ(truncated.error().code, utils::ErrorCode::kUnexpectedEnd);
+}
@@ -0,0 +1,138 @@
+#include <string_view>
+#include "gtest/gtest.h"
+#include "json/parser/tape.h"
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+using std::string_view;
+
+using json::parser::Tape;
+using json::utils::ErrorCode;
+
+using TapeType = Tape<char>::Type;
+
+TEST(TapeTest, Build) {
+  string_view json =
+      "{ \"a\": [1, -2.5, \"b\\\"c\"], \"d\": true, \"e\": null, "
+      "\"f\": 18446744073709551615 }";
+  Tape<char> tape;
+
+  ASSERT_TRUE(tape.Build(json.data(), json.data() + json.size()));
+  ASSERT_EQ(tape.size(), size_t{14});
+
+  EXPECT_EQ(tape[0].type, TapeType::kBeginObject);
+  EXPECT_EQ(tape[1].type, TapeType::kString);
+  EXPECT_EQ(tape.string(1), "a");
+  EXPECT_FALSE(tape[1].arena);
+
+  EXPECT_EQ(tape[2].type, TapeType::kBeginArray);
+  EXPECT_EQ(tape[3].type, TapeType::kInt64);
+  EXPECT_EQ(tape.int64(3), 1);
+  EXPECT_EQ(tape[4].type, TapeType::kDouble);
+  EXPECT_EQ(tape.number(4), -2.5);
+
+  // escaped strings are decoded into the arena
+  EXPECT_TRUE(tape[5].arena);
+  EXPECT_EQ(tape.string(5), "b\"c");
+  EXPECT_EQ(tape[6].type, TapeType::kEndArray);
+
+  EXPECT_EQ(tape[8].type, TapeType::kTrue);
+  EXPECT_EQ(tape[10].type, TapeType::kNull);
+  EXPECT_EQ(tape[12].type, TapeType::kUint64);
+  EXPECT_EQ(tape.uint64(12), uint64_t{18446744073709551615ULL});
+  EXPECT_EQ(tape[13].type, TapeType::kEndObject);
+}
+
+TEST(TapeTest, Skip) {
+  string_view json = "[[1, [2, 3]], {\"a\": {}}, 4]";
+  Tape<char> tape;
+
+  ASSERT_TRUE(tape.Build(json.data(), json.data() + json.size()));
+
+  // brackets reference each other
+  EXPECT_EQ(tape[0].payload, tape.size() - 1);
+  EXPECT_EQ(tape[tape.size() - 1].payload, uint64_t{0});
+
+  size_t index = 1;
+  size_t values = 0;
+
+  while (tape[index].type != TapeType::kEndArray) {
+    index = tape.Skip(index);
+    ++values;
+  }
+
+  EXPECT_EQ(values, size_t{3});
+  EXPECT_EQ(index, tape.size() - 1);
+}
+
+TEST(TapeTest, Reuse) {
+  Tape<char> tape;
+  string_view first = "[\"\\u0041\", 1, 2, 3]  ";
+  string_view second = "[\"\\u0042\"]";
+
+  ASSERT_TRUE(tape.Build(first.data(), first.data() + first.size()));
+  ASSERT_TRUE(tape.Build(second.data(), second.data() + second.size()));
+
+  ASSERT_EQ(tape.size(), size_t{3});
+  EXPECT_EQ(tape.string(1), "B");
+}
+
+TEST(TapeTest, Error) {
+  for (string_view json : {"[1, 2}", "{\"a\": [1]", "]", "[tru]", "[x]"}) {
+    Tape<char> tape;
+
+    EXPECT_FALSE(tape.Build(json.data(), json.data() + json.size())) << json;
+    EXPECT_NE(tape.error(), ErrorCode::kNone) << json;
+    EXPECT_EQ(tape.size(), size_t{0}) << json;
+  }
+}
+
+TEST(TapeTest, Grammar) {
+  // missing or extra separators, keys without values and trailing values
+  for (string_view json : {"[1 2 3]", "{\"a\" 1}", "1 2", "[1,,]", "{\"a\"}",
+                           "[1, 2}", "{\"a\": 1,}", "{1: 2}", "[:]"}) {
+    Tape<char> tape;
+
+    EXPECT_FALSE(tape.Build(json.data(), json.data() + json.size())) << json;
+    EXPECT_EQ(tape.error(), ErrorCode::kUnexpectedToken) << json;
+    EXPECT_EQ(tape.size(), size_t{0}) << json;
+  }
+
+  for (string_view json : {"[1.]", "[01]", "-"}) {
+    Tape<char> tape;
+
+    EXPECT_FALSE(tape.Build(json.data(), json.data() + json.size())) << json;
+    EXPECT_EQ(tape.error(), ErrorCode::kInvalidNumber) << json;
+  }
+
+  // a text without a value is not valid, as for the other entry points
+  for (string_view json : {"", "  ", "/* a */"}) {
+    Tape<char> tape;
+    json::token::Options options;
+    options.comments = true;
+
+    EXPECT_FALSE(tape.Build(json.data(), json.data() + json.size(), options))
+        << json;
+    EXPECT_EQ(tape.error(), ErrorCode::kUnexpectedEnd) << json;
+  }
+}
+
+#if defined(__linux__)
+TEST(TapeTest, TooLarge) {
+  // the pages are reserved but never touched
+  size_t size = size_t{UINT32_MAX} + 1;
+  void *pages = ::mmap(nullptr, size, PROT_READ,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  ASSERT_NE(pages, MAP_FAILED);
+
+  const char *text = static_cast<const char *>(pages);
+  Tape<char> tape;
+
+  EXPECT_FALSE(tape.Build(text, text + size));
+  EXPECT_EQ(tape.error(), ErrorCode::kTooLarge);
+
+  ::munmap(pages, size);
+}
+#endif
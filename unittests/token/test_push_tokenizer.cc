@@ -0,0 +1,166 @@
+#include <string>
+#include <string_view>
+#include <vector>
+#include "gtest/gtest.h"
+#include "json/token/push_tokenizer.h"
+#include "json/token/tokenizer.h"
+
+using std::string_view;
+using std::vector;
+
+using json::token::BufferTokenizer;
+using json::token::PushTokenizer;
+using json::token::Token;
+using json::utils::ErrorCode;
+
+using Tokens = vector<Token<char>>;
+
+namespace {
+struct Recorder {
+  void take(const Token<char> &token) { tokens.push_back(token); }
+
+  Tokens tokens;
+};
+}  // namespace
+
+TEST(PushTokenizerTest, Chunks) {
+  string_view json =
+      "{ \"a\": [1, -2.5e1, \"b\\\"c\\u0041\\ud83d\\ude00\"], \"d\": true, "
+      "\"e\": null, \"f\": false, \"g\": 18446744073709551615 }";
+  Tokens expected;
+
+  BufferTokenizer<char> tokenizer{json};
+
+  while (!tokenizer.Done()) {
+    tokenizer.Extract();
+    expected.push_back(tokenizer.token());
+  }
+
+  // every token must survive being cut at any position
+  for (size_t size = 1; size <= json.size(); ++size) {
+    Recorder recorder;
+    PushTokenizer<char, Recorder> push{recorder};
+
+    for (size_t i = 0; i < json.size(); i += size) {
+      std::string chunk{json.substr(i, size)};
+      ASSERT_TRUE(push.Feed(chunk.data(), chunk.size())) << size;
+    }
+
+    ASSERT_TRUE(push.Finish()) << size;
+    EXPECT_EQ(recorder.tokens, expected) << size;
+  }
+}
+
+TEST(PushTokenizerTest, Finish) {
+  // a number at the end of the input is only complete once finished
+  {
+    Recorder recorder;
+    PushTokenizer<char, Recorder> push{recorder};
+
+    ASSERT_TRUE(push.Feed("12", 2));
+    EXPECT_TRUE(recorder.tokens.empty());
+
+    ASSERT_TRUE(push.Feed("34", 2));
+    ASSERT_TRUE(push.Finish());
+    ASSERT_EQ(recorder.tokens.size(), size_t{1});
+    EXPECT_EQ(recorder.tokens[0].int64(), 1234);
+  }
+
+  // input ending inside a string or literal
+  for (string_view json : {"\"abc", "tru", "\"a\\u00"}) {
+    Recorder recorder;
+    PushTokenizer<char, Recorder> push{recorder};
+
+    ASSERT_TRUE(push.Feed(json.data(), json.size()));
+    EXPECT_FALSE(push.Finish()) << json;
+    EXPECT_EQ(push.error(), ErrorCode::kUnexpectedEnd) << json;
+  }
+
+  // invalid letters and literals
+  for (string_view json : {"[x]", "[truex]", "[nul]"}) {
+    Recorder recorder;
+    PushTokenizer<char, Recorder> push{recorder};
+
+    EXPECT_FALSE(push.Feed(json.data(), json.size()) && push.Finish())
+        << json;
+    EXPECT_NE(push.error(), ErrorCode::kNone) << json;
+  }
+
+  // invalid numbers, the last number is only checked once finished
+  for (string_view json : {"[-]", "[01]", "[1.e5]", "1.", "1e"}) {
+    Recorder recorder;
+    PushTokenizer<char, Recorder> push{recorder};
+
+    EXPECT_FALSE(push.Feed(json.data(), json.size()) && push.Finish())
+        << json;
+    EXPECT_EQ(push.error(), ErrorCode::kInvalidNumber) << json;
+  }
+}
+
+TEST(PushTokenizerTest, Comment) {
+  string_view json = "[1, /* a * b */ 2// c\n, true/**/]// end";
+  json::token::Options options;
+  options.comments = true;
+  options.comment_tokens = true;
+  Tokens expected;
+
+  BufferTokenizer<char> tokenizer{json, options};
+
+  while (!tokenizer.Done()) {
+    tokenizer.Extract();
+
+    // the buffer tokenizer may end on an uninitialized token
+    if (tokenizer.token().type != Token<char>::Type::kUninitialized) {
+      expected.push_back(tokenizer.token());
+    }
+  }
+
+  for (size_t size = 1; size <= json.size(); ++size) {
+    Recorder recorder;
+    PushTokenizer<char, Recorder> push{recorder, options};
+
+    for (size_t i = 0; i < json.size(); i += size) {
+      std::string chunk{json.substr(i, size)};
+      ASSERT_TRUE(push.Feed(chunk.data(), chunk.size())) << size;
+    }
+
+    ASSERT_TRUE(push.Finish()) << size;
+    EXPECT_EQ(recorder.tokens, expected) << size;
+  }
+
+  // an unterminated block comment
+  Recorder recorder;
+  PushTokenizer<char, Recorder> push{recorder, options};
+
+  ASSERT_TRUE(push.Feed("1 /* a", 6));
+  EXPECT_FALSE(push.Finish());
+  EXPECT_EQ(push.error(), ErrorCode::kUnexpectedEnd);
+}
+
+TEST(PushTokenizerTest, CommentStars) {
+  json::token::Options options;
+  options.comments = true;
+  options.comment_tokens = true;
+
+  for (string_view json : {"/* a **/1", "/***/1", "/* a ***/1", "/* * **/1"}) {
+    Tokens expected;
+    BufferTokenizer<char> tokenizer{json, options};
+
+    while (!tokenizer.Done()) {
+      tokenizer.Extract();
+      expected.push_back(tokenizer.token());
+    }
+
+    // every split, including the ones between the stars
+    for (size_t split = 0; split <= json.size(); ++split) {
+      Recorder recorder;
+      PushTokenizer<char, Recorder> push{recorder, options};
+
+      ASSERT_TRUE(push.Feed(json.data(), split)) << json << split;
+      ASSERT_TRUE(push.Feed(json.data() + split, json.size() - split))
+          << json << split;
+      ASSERT_TRUE(push.Finish()) << json << split;
+      EXPECT_EQ(recorder.tokens, expected) << json << split;
+    }
+  }
+}
@@ -0,0 +1,192 @@
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "gtest/gtest.h"
+#include "json/token/structural_index.h"
+#include "json/token/tokenizer.h"
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+using std::string;
+using std::string_view;
+using std::vector;
+
+using json::token::BufferTokenizer;
+using json::token::IndexedTokenizer;
+using json::token::StructuralIndex;
+using json::token::Token;
+using json::utils::simd::Isa;
+
+// Index the text one letter at a time, like the index a letter preceded by
+// an odd number of backslashes is escaped even outside of strings
+static vector<uint32_t> reference_index(string_view text) {
+  vector<uint32_t> offsets;
+  bool in_string = false;
+  bool escaped = false;
+  bool in_scalar = false;
+
+  for (uint32_t i = 0; i < text.size(); ++i) {
+    char letter = text[i];
+    bool is_escaped = escaped;
+
+    escaped = !escaped && letter == '\\';
+
+    if (in_string) {
+      if (letter == '\"' && !is_escaped) {
+        in_string = false;
+      }
+
+      continue;
+    }
+
+    if (letter == '\"' && is_escaped) {
+      letter = 'x';
+    }
+
+    switch (letter) {
+      case '{':
+      case '}':
+      case '[':
+      case ']':
+      case ':':
+      case ',':
+        offsets.push_back(i);
+        in_scalar = false;
+        break;
+      case '\"':
+        offsets.push_back(i);
+        in_string = true;
+        in_scalar = false;
+        break;
+      case ' ':
+      case '\t':
+      case '\r':
+      case '\n':
+        in_scalar = false;
+        break;
+      default:
+        if (!in_scalar) {
+          offsets.push_back(i);
+        }
+
+        in_scalar = true;
+        break;
+    }
+  }
+
+  return offsets;
+}
+
+static vector<Isa> supported_isas() {
+  vector<Isa> isas{Isa::kScalar};
+
+  if (json::utils::simd::DetectIsa() >= Isa::kSse42) {
+    isas.push_back(Isa::kSse42);
+  }
+
+  if (json::utils::simd::DetectIsa() >= Isa::kAvx2) {
+    isas.push_back(Isa::kAvx2);
+  }
+
+  return isas;
+}
+
+TEST(StructuralIndexTest, Simple) {
+  string_view json = "{ \"a\": [1, true], \"b{\": null }";
+  StructuralIndex index;
+  ASSERT_TRUE(index.Build(json.data(), json.data() + json.size()));
+
+  vector<uint32_t> expected{0, 2, 5, 7, 8, 9, 11, 15, 16, 18, 22, 24, 29};
+
+  EXPECT_EQ(index.offsets(), expected);
+}
+
+TEST(StructuralIndexTest, MatchesReference) {
+  const char alphabet[] = "{}[]:,\"\\ \n1ae";
+  std::mt19937 random{42};
+  std::uniform_int_distribution<size_t> pick{0, sizeof(alphabet) - 2};
+  StructuralIndex index;
+
+  for (size_t length : {1, 63, 64, 65, 200, 1000}) {
+    for (int round = 0; round < 50; ++round) {
+      string text;
+
+      for (size_t i = 0; i < length; ++i) {
+        text += alphabet[pick(random)];
+      }
+
+      vector<uint32_t> expected = reference_index(text);
+
+      for (Isa isa : supported_isas()) {
+        index.Build(text.data(), text.data() + text.size(), isa);
+        ASSERT_EQ(index.offsets(), expected) << text << " isa " << int(isa);
+      }
+    }
+  }
+}
+
+TEST(StructuralIndexTest, Wide) {
+  std::u16string_view json = u"[\"é\\\"\", 12]";
+  StructuralIndex index;
+  index.Build(json.data(), json.data() + json.size());
+
+  vector<uint32_t> expected{0, 1, 6, 8, 10};
+
+  EXPECT_EQ(index.offsets(), expected);
+}
+
+TEST(StructuralIndexTest, Tokenizer) {
+  string json = "[";
+
+  for (int i = 0; i < 20; ++i) {
+    json += "{ \"key \\\\\\\"\": \"value, [x]\",\n  \"n\": -12.5e1, ";
+    json += "\"t\": true, \"f\": false, \"z\": null }, ";
+  }
+
+  json += "[] ]   ";
+
+  StructuralIndex index;
+  index.Build(json.data(), json.data() + json.size());
+
+  BufferTokenizer<char> buffer{string_view{json}};
+  IndexedTokenizer<char> indexed{{string_view{json}, index}};
+
+  vector<Token<char>> expected;
+  vector<Token<char>> actual;
+
+  while (!buffer.Done()) {
+    buffer.Extract();
+    expected.push_back(buffer.token());
+  }
+
+  while (!indexed.Done()) {
+    indexed.Extract();
+    actual.push_back(indexed.token());
+  }
+
+  // the buffer tokenizer repeats the last token on trailing whitespaces
+  expected.pop_back();
+
+  EXPECT_EQ(actual, expected);
+}
+
+#if defined(__linux__)
+TEST(StructuralIndexTest, TooLarge) {
+  // the pages are reserved but never touched
+  size_t size = StructuralIndex::kMaxLength + size_t{1};
+  void *pages = ::mmap(nullptr, size, PROT_READ,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  ASSERT_NE(pages, MAP_FAILED);
+
+  const char *text = static_cast<const char *>(pages);
+  StructuralIndex index;
+
+  EXPECT_FALSE(index.Build(text, text + size));
+  EXPECT_EQ(index.size(), size_t{0});
+
+  ::munmap(pages, size);
+}
+#endif
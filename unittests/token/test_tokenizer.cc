@@ -1,6 +1,8 @@
 #include <iostream>
+#include <limits>
 #include <sstream>
 #include <string_view>
+#include <type_traits>
 #include <vector>
 #include "gtest/gtest.h"
 #include "json/token/tokenizer.h"
@@ -8,9 +10,11 @@
 using std::basic_string_view;
 using std::cout;
 using std::endl;
+using std::string;
 using std::string_view;
 using std::vector;
 
+using json::token::BufferTokenizer;
 using json::token::Token;
 using json::token::Tokenizer;
 
@@ -34,6 +38,19 @@ static vector<Token<CharT>> tokenize(basic_string_view<CharT> js) {
   return output;
 }
 
+template <typename CharT>
+static vector<Token<CharT>> tokenize_buffer(basic_string_view<CharT> js) {
+  vector<Token<CharT>> output;
+  BufferTokenizer<CharT> tokenizer{js};
+
+  while (!tokenizer.Done()) {
+    tokenizer.Extract();
+    output.push_back(tokenizer.token());
+  }
+
+  return output;
+}
+
 TEST(TokenizerTest, NonContextual) {
   string_view json = "{ }\r[]\t,\n:";
   Tokens tokens = tokenize(json);
@@ -87,39 +104,108 @@ TEST(TokenizerTest, String) {
     EXPECT_EQ(tokens, expected);
   }
 
-  // String with unicode
-  // A: 0x41
-  // y: 0x79
-
-  // utf8 string with hexes
+  // utf8 string with hexes, U+4179 is 3 bytes in utf8
   {
-    string_view json = "\"\\u4179\"";
+    string_view json = "\"\\u4179\\u0041\\u00e9\"";
 
     Tokens tokens = tokenize(json);
-    Tokens expected{{"Ay"}};
+    Tokens expected{{"\xe4\x85\xb9" "A" "\xc3\xa9"}};
 
     EXPECT_EQ(tokens, expected);
+    EXPECT_EQ(tokenize_buffer(json), expected);
   }
 
   // utf16 string with hexes
-  // {
-  //   basic_string_view<char16_t> json = u"\"\\u1189\"";
+  {
+    basic_string_view<char16_t> json = u"\"\\u1189\"";
 
-  //   vector<Token<char16_t>> tokens = tokenize(json);
-  //   vector<Token<char16_t>> expected{{u"ᆉ"}};
+    vector<Token<char16_t>> tokens = tokenize_buffer(json);
+    vector<Token<char16_t>> expected{{u"\u1189"}};
 
-  //   EXPECT_EQ(tokens, expected);
-  // }
+    EXPECT_EQ(tokens, expected);
+  }
 
   // utf32 string with hexes
-  // {
-  //   basic_string_view<char32_t> json = U"\"\\u1189\"";
+  {
+    basic_string_view<char32_t> json = U"\"\\u1189\"";
 
-  //   vector<Token<char32_t>> tokens = tokenize(json);
-  //   vector<Token<char32_t>> expected{{U"ᆉ"}};
+    vector<Token<char32_t>> tokens = tokenize_buffer(json);
+    vector<Token<char32_t>> expected{{U"\u1189"}};
 
-  //   EXPECT_EQ(tokens, expected);
-  // }
+    EXPECT_EQ(tokens, expected);
+  }
+}
+
+TEST(TokenizerTest, SurrogatePair) {
+  // U+1F600 is written as a pair of escapes
+  string_view json = "\"\\ud83d\\ude00!\"";
+
+  Tokens expected{{"\xf0\x9f\x98\x80!"}};
+
+  EXPECT_EQ(tokenize(json), expected);
+  EXPECT_EQ(tokenize_buffer(json), expected);
+
+  vector<Token<char16_t>> utf16{{u"\U0001f600!"}};
+  EXPECT_EQ(tokenize_buffer(basic_string_view<char16_t>{
+                u"\"\\ud83d\\ude00!\""}),
+            utf16);
+
+  vector<Token<char32_t>> utf32{{U"\U0001f600!"}};
+  EXPECT_EQ(tokenize_buffer(basic_string_view<char32_t>{
+                U"\"\\ud83d\\ude00!\""}),
+            utf32);
+
+  // surrogates outside of a pair are replaced
+  for (string_view lone : {"\"\\ud83dx\"", "\"\\ude00x\"", "\"\\ud83d\\nx\""}) {
+    string replaced = "\xef\xbf\xbd";
+    replaced += lone.find("\\n") != string_view::npos ? "\nx" : "x";
+
+    Tokens tokens{{replaced}};
+
+    EXPECT_EQ(tokenize(lone), tokens) << lone;
+    EXPECT_EQ(tokenize_buffer(lone), tokens) << lone;
+  }
+
+  // invalid hex digits
+  for (string_view invalid : {"\"\\u12g4\"", "\"\\q\"", "\"\\u12\""}) {
+    BufferTokenizer<char> tokenizer{invalid};
+    tokenizer.Extract();
+
+    EXPECT_EQ(tokenizer.error(), json::utils::ErrorCode::kInvalidEscape)
+        << invalid;
+  }
+}
+
+TEST(TokenizerTest, StringView) {
+  string_view json = "[\"Death Effects\", \"a\\tb\"]";
+  BufferTokenizer<char> tokenizer{json};
+
+  tokenizer.Extract();
+  tokenizer.Extract();
+
+  // no escape, reference the input
+  ASSERT_EQ(tokenizer.token().type, TType::kString);
+  EXPECT_TRUE(tokenizer.token().IsStringView());
+  EXPECT_EQ(tokenizer.token().string(), "Death Effects");
+  EXPECT_EQ(tokenizer.token().string().data(), json.data() + 2);
+
+  tokenizer.Extract();
+  tokenizer.Extract();
+
+  // escape, own the unescaped string
+  ASSERT_EQ(tokenizer.token().type, TType::kString);
+  EXPECT_FALSE(tokenizer.token().IsStringView());
+  EXPECT_EQ(tokenizer.token().string(), "a\tb");
+}
+
+TEST(TokenizerTest, LongString) {
+  std::string text(100, 'a');
+  std::string json = "\"" + text + "\\n" + text + "\\\"\"";
+
+  Tokens expected{{text + "\n" + text + "\""}};
+
+  EXPECT_EQ(tokenize_buffer(string_view{json}), expected);
+  EXPECT_EQ(tokenize(string_view{json}), expected);
 }
 
 TEST(TokenizerTest, Number) {
@@ -184,6 +270,181 @@ TEST(TokenizerTest, Number) {
   }
 }
 
+TEST(TokenizerTest, NumberRounding) {
+  std::pair<string_view, double> cases[] = {
+      {"0.1", 0.1},
+      {"-0.3", -0.3},
+      {"9007199254740993", 9007199254740992.0},
+      {"123456789012345678901234567890", 1.2345678901234568e29},
+      {"1.7976931348623157e308", 1.7976931348623157e308},
+      {"2.2250738585072011e-308", 2.2250738585072011e-308},
+      {"5e-324", 5e-324},
+      {"0.000000000000000000000000000001", 1e-30},
+      {"1e400", std::numeric_limits<double>::infinity()},
+      {"-1e-400", -0.0},
+  };
+
+  for (const auto &[json, expected] : cases) {
+    Tokens buffered = tokenize_buffer(json);
+    Tokens streamed = tokenize(json);
+
+    ASSERT_EQ(buffered.size(), size_t{1});
+    ASSERT_EQ(streamed.size(), size_t{1});
+
+    EXPECT_EQ(buffered[0].number(), expected) << json;
+    EXPECT_EQ(streamed[0].number(), expected) << json;
+  }
+}
+
+TEST(TokenizerTest, Integer) {
+  // fits in a signed integer
+  {
+    Tokens tokens = tokenize_buffer(string_view{"-9223372036854775808 42"});
+
+    ASSERT_EQ(tokens.size(), size_t{2});
+    ASSERT_TRUE(tokens[0].IsInteger());
+    EXPECT_EQ(tokens[0].int64(), INT64_MIN);
+    ASSERT_TRUE(tokens[1].IsInteger());
+    EXPECT_EQ(tokens[1].int64(), 42);
+  }
+
+  // only fits in an unsigned integer
+  {
+    Tokens tokens = tokenize(string_view{"18446744073709551615"});
+
+    ASSERT_EQ(tokens.size(), size_t{1});
+    ASSERT_TRUE(tokens[0].IsInteger());
+    EXPECT_EQ(tokens[0].uint64(), UINT64_MAX);
+  }
+
+  // too large, fraction, exponent or negative zero
+  for (string_view json : {"18446744073709551616", "1.0", "1e2", "-0"}) {
+    Tokens tokens = tokenize_buffer(json);
+
+    ASSERT_EQ(tokens.size(), size_t{1});
+    EXPECT_FALSE(tokens[0].IsInteger()) << json;
+  }
+}
+
+TEST(TokenizerTest, InvalidNumber) {
+  for (string_view invalid : {"-", "[-]", "1.", "01", "1e", "-.5", "[1.e5]"}) {
+    for (bool lazy : {false, true}) {
+      BufferTokenizer<char> buffered{invalid, {/* lazy_numbers */ lazy}};
+
+      while (!buffered.Done()) {
+        buffered.Extract();
+      }
+
+      EXPECT_EQ(buffered.error(), json::utils::ErrorCode::kInvalidNumber)
+          << invalid;
+    }
+
+    std::stringstream stream{std::string{invalid}};
+    Tokenizer<char> streamed{stream};
+
+    while (!streamed.Done()) {
+      streamed.Extract();
+    }
+
+    EXPECT_EQ(streamed.error(), json::utils::ErrorCode::kInvalidNumber)
+        << invalid;
+  }
+}
+
+namespace {
+/**
+ * @brief Compact token that only takes a few letters, to test the length
+ * limit without a text of 4GiB
+ */
+struct ShortToken : json::token::CompactToken<char> {
+  static constexpr size_t kMaxLength = 4;
+};
+}  // namespace
+
+TEST(TokenizerTest, TooLong) {
+  using ShortTokenizer =
+      Tokenizer<char, json::token::BufferInput<char>, ShortToken>;
+
+  json::token::Options options;
+  options.comments = true;
+  options.comment_tokens = true;
+  options.lazy_numbers = true;
+
+  ShortTokenizer fits{string_view{"\"abcd\""}, options};
+  fits.Extract();
+  EXPECT_EQ(fits.token().string(), "abcd");
+
+  // views of the input, decoded strings, comments and raw numbers
+  for (string_view json : {"\"abcde\"", "\"a\\nbcd\"", "/* abc */", "12345"}) {
+    ShortTokenizer tokenizer{json, options};
+    tokenizer.Extract();
+
+    EXPECT_EQ(tokenizer.error(), json::utils::ErrorCode::kTooLarge) << json;
+    EXPECT_TRUE(tokenizer.Done()) << json;
+  }
+}
+
+TEST(TokenizerTest, LazyNumber) {
+  string_view json = "[0.1, 18446744073709551615, -7]";
+  BufferTokenizer<char> tokenizer{json, {/* lazy_numbers */ true}};
+  Tokens tokens;
+
+  while (!tokenizer.Done()) {
+    tokenizer.Extract();
+    tokens.push_back(tokenizer.token());
+  }
+
+  ASSERT_EQ(tokens.size(), size_t{7});
+
+  // the letters are referenced from the input
+  ASSERT_TRUE(tokens[1].IsRawNumber());
+  EXPECT_EQ(tokens[1].string().data(), json.data() + 1);
+  EXPECT_EQ(tokens[1].string(), "0.1");
+  EXPECT_EQ(tokens[1].number(), 0.1);
+  EXPECT_FALSE(tokens[1].IsInteger());
+
+  ASSERT_TRUE(tokens[3].IsInteger());
+  EXPECT_EQ(tokens[3].uint64(), UINT64_MAX);
+  EXPECT_EQ(tokens[5].int64(), -7);
+
+  // compare equal to eagerly converted tokens
+  EXPECT_EQ(tokens, tokenize_buffer(json));
+}
+
+TEST(TokenizerTest, Utf8) {
+  json::token::Options options;
+  options.validate_utf8 = true;
+
+  // valid text, with and without escapes, is accepted
+  for (string_view json : {"\"caf\xc3\xa9\"", "\"\xe2\x82\xac\\n\xc3\xa9\""}) {
+    BufferTokenizer<char> tokenizer{json, options};
+    tokenizer.Extract();
+
+    EXPECT_EQ(tokenizer.error(), json::utils::ErrorCode::kNone) << json;
+    EXPECT_EQ(tokenizer.token().type, TType::kString) << json;
+  }
+
+  // invalid text is rejected, before and after escapes, from a stream too
+  for (string_view json : {"\"\xc3\"", "\"a\\n\xed\xa0\x80\""}) {
+    BufferTokenizer<char> buffered{json, options};
+    buffered.Extract();
+
+    EXPECT_EQ(buffered.error(), json::utils::ErrorCode::kInvalidUtf8) << json;
+
+    std::stringstream stream{std::string{json}};
+    Tokenizer<char> streamed{stream, options};
+    streamed.Extract();
+
+    EXPECT_EQ(streamed.error(), json::utils::ErrorCode::kInvalidUtf8) << json;
+
+    // not checked by default
+    BufferTokenizer<char> unchecked{json};
+    unchecked.Extract();
+
+    EXPECT_EQ(unchecked.error(), json::utils::ErrorCode::kNone) << json;
+  }
+}
+
 TEST(TokenizerTest, Bool) {
   // utf8
   {
@@ -215,4 +476,197 @@ TEST(TokenizerTest, Null) {
   Tokens expected{{TType::kNull}, {TType::kNull}};
 
   EXPECT_EQ(tokens, expected);
-}
\ No newline at end of file
+}
+
+TEST(TokenizerTest, Literal) {
+  string_view json = "[true,false,null]";
+  Tokens expected{{TType::kBeginArray},     {TType::kBoolean, true},
+                  {TType::kValueSeparator}, {TType::kBoolean, false},
+                  {TType::kValueSeparator}, {TType::kNull},
+                  {TType::kEndArray}};
+
+  EXPECT_EQ(tokenize_buffer(json), expected);
+  EXPECT_EQ(tokenize(json), expected);
+
+  // mismatch, missing delimiter and truncated literals are rejected
+  for (string_view invalid : {"trUe", "fals", "nulL", "truex", "null1"}) {
+    BufferTokenizer<char> buffered{invalid};
+    buffered.Extract();
+
+    EXPECT_NE(buffered.error(), json::utils::ErrorCode::kNone) << invalid;
+    EXPECT_TRUE(buffered.Done()) << invalid;
+
+    std::stringstream stream{std::string{invalid}};
+    Tokenizer<char> streamed{stream};
+    streamed.Extract();
+
+    EXPECT_EQ(streamed.error(), buffered.error()) << invalid;
+  }
+}
+
+TEST(TokenizerTest, Comment) {
+  string_view json = "// head\n[1, /* two */ 2 /**/, true// x\n]/* end */";
+  Tokens expected{{TType::kBeginArray},     {1.0},
+                  {TType::kValueSeparator}, {2.0},
+                  {TType::kValueSeparator}, {TType::kBoolean, true},
+                  {TType::kEndArray}};
+  json::token::Options options;
+  options.comments = true;
+
+  for (bool buffered : {true, false}) {
+    std::stringstream stream{std::string{json}};
+    Tokens tokens;
+
+    if (buffered) {
+      BufferTokenizer<char> tokenizer{json, options};
+
+      while (!tokenizer.Done()) {
+        tokenizer.Extract();
+        tokens.push_back(tokenizer.token());
+      }
+    } else {
+      Tokenizer<char> tokenizer{stream, options};
+
+      while (!tokenizer.Done()) {
+        tokenizer.Extract();
+        tokens.push_back(tokenizer.token());
+      }
+    }
+
+    // the tokenizer ends on an uninitialized token after the last comment
+    ASSERT_FALSE(tokens.empty());
+    tokens.pop_back();
+    EXPECT_EQ(tokens, expected) << buffered;
+  }
+
+  // the text of comments is only kept on request
+  options.comment_tokens = true;
+  BufferTokenizer<char> tokenizer{string_view{"/* a */ 1 // b"}, options};
+  vector<string> comments;
+
+  while (!tokenizer.Done()) {
+    tokenizer.Extract();
+
+    if (tokenizer.token().type == TType::kComment) {
+      comments.emplace_back(tokenizer.token().string());
+    }
+  }
+
+  EXPECT_EQ(comments, (vector<string>{" a ", " b"}));
+
+  // comments must be enabled, complete and well formed
+  for (string_view invalid : {"/* a */ 1", "1 /* a", "1 /x"}) {
+    json::token::Options strict;
+    strict.comments = invalid[0] != '/';
+    BufferTokenizer<char> buffered{invalid, strict};
+
+    while (!buffered.Done()) {
+      buffered.Extract();
+    }
+
+    EXPECT_NE(buffered.error(), json::utils::ErrorCode::kNone) << invalid;
+  }
+}
+
+TEST(TokenizerTest, Compact) {
+  string_view json =
+      "{ \"a\": [1, -2.5e1, \"b\\\"c\"], \"d\": true, \"e\": null, "
+      "\"f\": 18446744073709551615, \"g\": \"\\u0041\" }";
+
+  static_assert(std::is_trivially_copyable_v<json::token::CompactToken<char>>);
+
+  // compact tokens must carry the same data as tokens, whether the letters
+  // are referenced in the input or in the buffer of the tokenizer
+  for (bool buffered : {true, false}) {
+    std::stringstream stream{std::string{json}};
+    BufferTokenizer<char> expected{json};
+    json::token::CompactTokenizer<char> compact{json};
+    json::token::CompactTokenizer<char, json::token::StreamInput<char>>
+        streamed{stream};
+
+    while (!expected.Done()) {
+      expected.Extract();
+
+      const Token<char> &token = expected.token();
+      json::token::CompactToken<char> other;
+
+      if (buffered) {
+        compact.Extract();
+        other = compact.token();
+      } else {
+        streamed.Extract();
+        other = streamed.token();
+      }
+
+      ASSERT_EQ(other.type, token.type);
+
+      switch (token.type) {
+        case TType::kString:
+          EXPECT_EQ(other.string(), token.string());
+          break;
+        case TType::kNumber:
+          EXPECT_EQ(other.NumberValue(), token.NumberValue());
+          break;
+        case TType::kBoolean:
+          EXPECT_EQ(other.boolean(), token.boolean());
+          break;
+        default:
+          break;
+      }
+    }
+  }
+}
+
+TEST(TokenizerTest, Buffer) {
+  string_view json =
+      "{ \"a\": [1, -2.5e1, \"b\\\"c\"], \"d\": true, \"e\": null }";
+
+  Tokens tokens = tokenize_buffer(json);
+  Tokens expected{{TType::kBeginObject},
+                  {"a"},
+                  {TType::kKeyValueSeparator},
+                  {TType::kBeginArray},
+                  {1.0},
+                  {TType::kValueSeparator},
+                  {-25.0},
+                  {TType::kValueSeparator},
+                  {"b\"c"},
+                  {TType::kEndArray},
+                  {TType::kValueSeparator},
+                  {"d"},
+                  {TType::kKeyValueSeparator},
+                  {TType::kBoolean, true},
+                  {TType::kValueSeparator},
+                  {"e"},
+                  {TType::kKeyValueSeparator},
+                  {TType::kNull},
+                  {TType::kEndObject}};
+
+  EXPECT_EQ(tokens, expected);
+  EXPECT_EQ(tokens, tokenize(json));
+}
+
+TEST(TokenizerTest, RecordSeparators) {
+  string_view json = "\x1etrue\x1e[null]\x1e";
+  json::token::Options options;
+
+  BufferTokenizer<char> rejected{json};
+  rejected.Extract();
+  EXPECT_EQ(rejected.error(), json::utils::ErrorCode::kUnexpectedLetter);
+
+  options.record_separators = true;
+  BufferTokenizer<char> tokenizer{json, options};
+  Tokens tokens;
+
+  while (!tokenizer.Done()) {
+    tokenizer.Extract();
+    tokens.push_back(tokenizer.token());
+  }
+
+  EXPECT_EQ(tokenizer.error(), json::utils::ErrorCode::kNone);
+  ASSERT_GE(tokens.size(), size_t{4});
+  EXPECT_EQ(tokens[0].type, TType::kBoolean);
+  EXPECT_EQ(tokens[1].type, TType::kBeginArray);
+  EXPECT_EQ(tokens[2].type, TType::kNull);
+  EXPECT_EQ(tokens[3].type, TType::kEndArray);
+}
@@ -0,0 +1,40 @@
+#include <optional>
+#include <thread>
+#include "gtest/gtest.h"
+#include "json/utils/bounded_queue.h"
+
+using json::utils::BoundedQueue;
+
+TEST(BoundedQueueTest, PushPop) {
+  BoundedQueue<int> queue{4};
+
+  std::thread producer{[&queue]() {
+    for (int i = 0; i < 1000; ++i) {
+      queue.Push(int{i});
+    }
+
+    queue.Close();
+  }};
+
+  int expected = 0;
+
+  while (std::optional<int> item = queue.Pop()) {
+    EXPECT_EQ(*item, expected);
+    ++expected;
+  }
+
+  producer.join();
+  EXPECT_EQ(expected, 1000);
+}
+
+TEST(BoundedQueueTest, Close) {
+  BoundedQueue<int> queue{1};
+
+  ASSERT_TRUE(queue.Push(1));
+  queue.Close();
+
+  // the items left are popped, items pushed after closing are dropped
+  EXPECT_FALSE(queue.Push(2));
+  EXPECT_EQ(queue.Pop(), std::optional<int>{1});
+  EXPECT_EQ(queue.Pop(), std::nullopt);
+}
@@ -0,0 +1,41 @@
+#include "gtest/gtest.h"
+#include "json/utils/char_class.h"
+
+using namespace json::utils::char_class;
+
+TEST(CharClassTest, Classes) {
+  static_assert(Is(' ', kWhitespace));
+  static_assert(Is('{', kStructural));
+  static_assert(Is('7', kDigit | kNumber));
+  static_assert(Is('e', kHexDigit | kNumber | kEscape) &&
+                !Is('e', kDigit));
+
+  for (int letter = 0; letter < 256; ++letter) {
+    bool whitespace = letter == ' ' || letter == '\t' || letter == '\r' ||
+                      letter == '\n';
+    bool digit = letter >= '0' && letter <= '9';
+
+    EXPECT_EQ(Is(char(letter), kWhitespace), whitespace) << letter;
+    EXPECT_EQ(Is(char(letter), kDigit), digit) << letter;
+  }
+
+  // wide letters outside of the ascii range have no class
+  EXPECT_FALSE(Is(u'０', kDigit));
+  EXPECT_FALSE(Is(U'\U0001f600', kWhitespace));
+  EXPECT_TRUE(Is(U'[', kStructural));
+}
+
+TEST(CharClassTest, Entries) {
+  EXPECT_EQ(Lookup('[').dispatch, Dispatch::kBeginArray);
+  EXPECT_EQ(Lookup('-').dispatch, Dispatch::kNumber);
+  EXPECT_EQ(Lookup('n').dispatch, Dispatch::kNull);
+  EXPECT_EQ(Lookup('x').dispatch, Dispatch::kInvalid);
+
+  EXPECT_EQ(Lookup('n').escaped, '\n');
+  EXPECT_EQ(Lookup('/').escaped, '/');
+  EXPECT_EQ(Lookup('u').escaped, 0);
+  EXPECT_TRUE(Is('u', kEscape));
+
+  EXPECT_EQ(Lookup('B').value, 11);
+  EXPECT_EQ(Lookup('g').value, -1);
+}
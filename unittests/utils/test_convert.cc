@@ -1,3 +1,4 @@
+#include <string_view>
 #include "gtest/gtest.h"
 #include "json/utils/convert.h"
 
@@ -68,4 +69,56 @@ TEST(ConverTest, FromDec) {
     auto value = number::FromDec<int>(U'3');
     EXPECT_EQ(value, 3);
   }
-}
\ No newline at end of file
+}
+
+TEST(ConvertTest, FastToDouble) {
+  double value = 0.0;
+
+  // 12.5
+  {
+    number::Decimal decimal;
+    decimal.mantissa = 125;
+    decimal.exponent = -1;
+
+    ASSERT_TRUE(number::FastToDouble(decimal, value));
+    EXPECT_EQ(value, 12.5);
+  }
+
+  // exponent too large for a single exact operation
+  {
+    number::Decimal decimal;
+    decimal.mantissa = 1;
+    decimal.exponent = 23;
+
+    EXPECT_FALSE(number::FastToDouble(decimal, value));
+  }
+}
+
+TEST(ConvertTest, ToDouble) {
+  std::string_view text = "-4.9406564584124654e-324";
+  EXPECT_EQ(number::ToDouble(text.data(), text.data() + text.size()),
+            -4.9406564584124654e-324);
+
+  std::u16string_view wide = u"1e23";
+  EXPECT_EQ(number::ToDouble(wide.data(), wide.data() + wide.size()), 1e23);
+}
+
+TEST(ConvertTest, Scan) {
+  const auto scan = [](std::string_view text) -> const char * {
+    number::Decimal decimal;
+    return number::Scan(text.data(), text.data() + text.size(), decimal);
+  };
+
+  for (std::string_view text : {"0", "-0", "10", "-1.25", "0.5e-3", "7E+2"}) {
+    EXPECT_EQ(scan(text), text.data() + text.size()) << text;
+  }
+
+  // the letters after the number are not part of it
+  std::string_view trailing = "1.5.2";
+  EXPECT_EQ(scan(trailing), trailing.data() + 3);
+
+  for (std::string_view text : {"", "-", "01", "-01", "1.", "1.e5", "-.5",
+                                ".5", "1e", "1e+", "+1"}) {
+    EXPECT_EQ(scan(text), nullptr) << text;
+  }
+}
@@ -0,0 +1,53 @@
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+#include "json/utils/simd.h"
+
+using std::string;
+using std::vector;
+
+using namespace json::utils::simd;
+
+static vector<Isa> supported_isas() {
+  vector<Isa> isas{Isa::kScalar};
+
+  if (DetectIsa() >= Isa::kSse42) {
+    isas.push_back(Isa::kSse42);
+  }
+
+  if (DetectIsa() >= Isa::kAvx2) {
+    isas.push_back(Isa::kAvx2);
+  }
+
+  return isas;
+}
+
+TEST(SimdTest, FindQuoteOrBackslash) {
+  for (Isa isa : supported_isas()) {
+    Finder find = SelectFinder(isa);
+
+    for (size_t length = 0; length < 100; ++length) {
+      string text(length, 'a');
+
+      // none
+      EXPECT_EQ(find(text.data(), text.data() + length), text.data() + length);
+
+      for (size_t position = 0; position < length; ++position) {
+        text[position] = position % 2 == 0 ? '\"' : '\\';
+
+        const char *found = find(text.data(), text.data() + length);
+        EXPECT_EQ(size_t(found - text.data()), position);
+
+        text[position] = 'a';
+      }
+    }
+  }
+}
+
+TEST(SimdTest, FindQuoteOrBackslashWide) {
+  std::u32string text = U"aaaaé\\a\"";
+  const char32_t *found =
+      FindQuoteOrBackslash(text.data(), text.data() + text.size());
+
+  EXPECT_EQ(found - text.data(), 5);
+}
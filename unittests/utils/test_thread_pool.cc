@@ -0,0 +1,38 @@
+#include <atomic>
+#include <future>
+#include <vector>
+#include "gtest/gtest.h"
+#include "json/utils/thread_pool.h"
+
+using json::utils::ThreadPool;
+
+TEST(ThreadPoolTest, Submit) {
+  ThreadPool pool{3};
+  std::vector<std::future<int>> futures;
+
+  ASSERT_EQ(pool.size(), size_t{3});
+
+  for (int i = 0; i < 100; ++i) {
+    futures.push_back(pool.Submit([i]() { return i * i; }));
+  }
+
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(futures[i].get(), i * i);
+  }
+}
+
+TEST(ThreadPoolTest, Destruction) {
+  std::atomic<int> count{0};
+
+  {
+    ThreadPool pool{0};
+    ASSERT_EQ(pool.size(), size_t{1});
+
+    for (int i = 0; i < 50; ++i) {
+      pool.Submit([&count]() { ++count; });
+    }
+  }
+
+  // the tasks left are run before the threads stop
+  EXPECT_EQ(count.load(), 50);
+}
@@ -0,0 +1,81 @@
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+#include "json/utils/transcode.h"
+
+using std::string;
+using std::u16string;
+using std::u32string;
+using std::vector;
+
+using json::utils::simd::DetectIsa;
+using json::utils::simd::Isa;
+using namespace json::utils::transcode;
+
+static vector<Isa> isas() {
+  vector<Isa> all{Isa::kScalar};
+
+  if (DetectIsa() >= Isa::kSse42) {
+    all.push_back(Isa::kSse42);
+  }
+
+  if (DetectIsa() >= Isa::kAvx2) {
+    all.push_back(Isa::kAvx2);
+  }
+
+  return all;
+}
+
+TEST(TranscodeTest, Sequences) {
+  string sequences = "a\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80z";
+  u16string utf16 = u"aé€\U0001F600z";
+  u32string utf32 = U"aé€\U0001F600z";
+
+  for (Isa isa : isas()) {
+    // at every offset of a block, and across the end of blocks
+    for (size_t padding = 0; padding < 70; ++padding) {
+      string text = string(padding, 'a') + sequences + string(padding, 'b');
+      u16string output16 = u"<";
+      u32string output32 = U"<";
+
+      SelectTranscoder<char16_t>(isa)(text.data(), text.data() + text.size(),
+                                      output16);
+      SelectTranscoder<char32_t>(isa)(text.data(), text.data() + text.size(),
+                                      output32);
+
+      EXPECT_EQ(output16, u"<" + u16string(padding, u'a') + utf16 +
+                              u16string(padding, u'b'))
+          << padding;
+      EXPECT_EQ(output32, U"<" + u32string(padding, U'a') + utf32 +
+                              u32string(padding, U'b'))
+          << padding;
+    }
+  }
+}
+
+TEST(TranscodeTest, Invalid) {
+  struct Case {
+    string text;
+    u32string expected;
+  };
+
+  vector<Case> cases{{"\x80", U"�"},
+                     {"a\xc3", U"a�"},
+                     {"\xc0\xaf", U"��"},
+                     {"\xed\xa0\x80", U"���"},
+                     {"\xe2\x82\x41", U"�A"},
+                     {"\xf4\x90\x80\x80", U"����"},
+                     {"\xf0\x9f\x98", U"�"}};
+
+  for (Isa isa : isas()) {
+    for (const Case &c : cases) {
+      string text = string(40, ' ') + c.text;
+      u32string output;
+
+      SelectTranscoder<char32_t>(isa)(text.data(), text.data() + text.size(),
+                                      output);
+
+      EXPECT_EQ(output, u32string(40, U' ') + c.expected);
+    }
+  }
+}
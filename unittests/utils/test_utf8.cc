@@ -0,0 +1,91 @@
+#include <random>
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+#include "json/utils/utf8.h"
+
+using std::string;
+using std::vector;
+
+using json::utils::simd::DetectIsa;
+using json::utils::simd::Isa;
+using namespace json::utils::utf8;
+
+static vector<Validator> validators() {
+  vector<Validator> all{SelectValidator(Isa::kScalar)};
+
+  if (DetectIsa() >= Isa::kSse42) {
+    all.push_back(SelectValidator(Isa::kSse42));
+  }
+
+  if (DetectIsa() >= Isa::kAvx2) {
+    all.push_back(SelectValidator(Isa::kAvx2));
+  }
+
+  return all;
+}
+
+TEST(Utf8Test, Sequences) {
+  vector<string> valid{"",
+                       "ascii",
+                       "\xc3\xa9",
+                       "\xe2\x82\xac",
+                       "\xed\x9f\xbf",
+                       "\xf0\x9f\x98\x80",
+                       "\xf4\x8f\xbf\xbf"};
+  vector<string> invalid{"\x80",              // lone continuation
+                         "\xc3",              // truncated
+                         "\xc0\xaf",          // overlong 2 bytes
+                         "\xe0\x80\xaf",      // overlong 3 bytes
+                         "\xed\xa0\x80",      // surrogate
+                         "\xf0\x80\x80\xaf",  // overlong 4 bytes
+                         "\xf4\x90\x80\x80",  // above U+10FFFF
+                         "\xf5\x80\x80\x80",  // invalid lead
+                         "\xe2\x82\x41",      // missing continuation
+                         "\xc3\xa9\xa9"};     // extra continuation
+
+  for (Validator validate : validators()) {
+    // at every offset of a block, and across the end of blocks
+    for (size_t padding = 0; padding < 70; ++padding) {
+      for (const string &sequence : valid) {
+        string text = string(padding, 'a') + sequence + "b";
+        EXPECT_TRUE(validate(text.data(), text.data() + text.size()))
+            << padding << " " << sequence;
+      }
+
+      for (const string &sequence : invalid) {
+        string text = string(padding, 'a') + sequence;
+        EXPECT_FALSE(validate(text.data(), text.data() + text.size()))
+            << padding << " " << sequence;
+
+        text += "bbbb";
+        EXPECT_FALSE(validate(text.data(), text.data() + text.size()))
+            << padding << " " << sequence;
+      }
+    }
+  }
+}
+
+TEST(Utf8Test, Random) {
+  std::mt19937 random{42};
+  vector<Validator> all = validators();
+  const char *pieces[] = {"a", "\xc3\xa9", "\xe2\x82\xac", "\xf0\x9f\x98\x80",
+                          "\x80", "\xed\xa0\x80"};
+
+  for (int i = 0; i < 2000; ++i) {
+    string text;
+    size_t count = random() % 40;
+
+    // mostly valid pieces, sometimes an invalid one
+    for (size_t j = 0; j < count; ++j) {
+      text += pieces[random() % (i % 2 == 0 ? 4 : 6)];
+    }
+
+    bool expected = ValidateScalar(text.data(), text.data() + text.size());
+
+    for (Validator validate : all) {
+      EXPECT_EQ(validate(text.data(), text.data() + text.size()), expected)
+          << i;
+    }
+  }
+}
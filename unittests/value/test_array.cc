@@ -108,4 +108,20 @@ TEST(BasicArrayTest, Erase) {
 
   ASSERT_EQ(array.size(), size_t{1});
   EXPECT_EQ(array[0].string(), "element 1");
-}
\ No newline at end of file
+}
+
+TEST(BasicArrayTest, Merge) {
+  Value array{VType::kArray};
+  Value other{VType::kArray};
+
+  array.Append(Value{"element 1"});
+  other.Append(Value{"element 2"});
+  other.Append(Value{"element 3"});
+
+  array.Merge(std::move(other));
+
+  ASSERT_EQ(array.size(), size_t{3});
+  EXPECT_EQ(array[0].string(), "element 1");
+  EXPECT_EQ(array[2].string(), "element 3");
+  EXPECT_EQ(other.size(), size_t{0});
+}
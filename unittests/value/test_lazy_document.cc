@@ -0,0 +1,107 @@
+#include <string>
+#include <string_view>
+#include "gtest/gtest.h"
+#include "json/value/basic_lazy_document.h"
+
+using std::string;
+using std::string_view;
+
+using Document = json::BasicLazyDocument<char>;
+using Value = json::BasicValue<char>;
+using VType = Value::Type;
+
+TEST(LazyDocumentTest, Navigate) {
+  string_view json =
+      "{\"Name\": \"Goblin \\\"G\\\"\", \"Stats\": {\"Attack\": 5, "
+      "\"Skip\": [{\"}\": \"]\"}, [1, 2]]}, \"Death Effects\": {\"Rock\": 3,"
+      " \"Health\": -1.5e1}, \"Alive\": true, \"Tags\": [\"a\", null, []]}";
+  Document document{json};
+
+  ASSERT_TRUE(document.root().IsObject());
+  EXPECT_EQ(document.root().size(), size_t{5});
+
+  EXPECT_EQ(document["Name"].string(), "Goblin \"G\"");
+  EXPECT_DOUBLE_EQ(document["Death Effects"]["Health"].number(), -15);
+  EXPECT_DOUBLE_EQ(document["Stats"]["Attack"].number(), 5);
+  EXPECT_TRUE(document["Alive"].boolean());
+
+  EXPECT_TRUE(document.Contains("Tags"));
+  EXPECT_EQ(document["Tags"].size(), size_t{3});
+  EXPECT_EQ(document["Tags"][0].string(), "a");
+  EXPECT_EQ(document["Tags"][1].type(), VType::kNull);
+  EXPECT_FALSE(document["Tags"][1].IsMissing());
+  EXPECT_EQ(document["Tags"][2].size(), size_t{0});
+  EXPECT_TRUE(document["Tags"][3].IsMissing());
+  EXPECT_TRUE(document["Tags"][2][0].IsMissing());
+}
+
+TEST(LazyDocumentTest, Missing) {
+  Document document{string_view{"{\"a\": {\"b\": 1}}"}};
+
+  EXPECT_FALSE(document.Contains("b"));
+  EXPECT_TRUE(document["b"].IsMissing());
+  EXPECT_TRUE(document["b"]["c"].IsMissing());
+  EXPECT_TRUE(document["a"][0].IsMissing());
+  EXPECT_TRUE(document["a"]["b"]["c"].IsMissing());
+  EXPECT_EQ(document["a"]["b"].string(), "");
+
+  EXPECT_TRUE(Document{string_view{""}}.root().IsMissing());
+}
+
+TEST(LazyDocumentTest, Error) {
+  using json::utils::ErrorCode;
+
+  Document document{string_view{
+      "[true, false, tx, trash, 12x, \"a\\q\", null, \"\\n\", 2, t]"}};
+
+  EXPECT_TRUE(document[0].boolean());
+  EXPECT_EQ(document[0].error(), ErrorCode::kNone);
+  EXPECT_FALSE(document[1].boolean());
+  EXPECT_EQ(document[1].error(), ErrorCode::kNone);
+
+  // literals are tokenized, not guessed from their first letter
+  EXPECT_FALSE(document[2].boolean());
+  EXPECT_NE(document[2].error(), ErrorCode::kNone);
+  EXPECT_FALSE(document[3].boolean());
+  EXPECT_EQ(document[3].error(), ErrorCode::kInvalidLiteral);
+  EXPECT_FALSE(document[9].boolean());
+  EXPECT_NE(document[9].error(), ErrorCode::kNone);
+
+  // values that are not valid read as 0 or empty, and report why
+  EXPECT_DOUBLE_EQ(document[4].number(), 0);
+  EXPECT_NE(document[4].error(), ErrorCode::kNone);
+  EXPECT_EQ(document[5].string(), "");
+  EXPECT_EQ(document[5].error(), ErrorCode::kInvalidEscape);
+
+  EXPECT_EQ(document[6].error(), ErrorCode::kNone);
+  EXPECT_EQ(document[7].string(), "\n");
+  EXPECT_EQ(document[7].error(), ErrorCode::kNone);
+  EXPECT_DOUBLE_EQ(document[8].number(), 2);
+  EXPECT_EQ(document[8].error(), ErrorCode::kNone);
+
+  EXPECT_EQ(document.root().error(), ErrorCode::kNone);
+  EXPECT_EQ(document[10].error(), ErrorCode::kNone);
+}
+
+TEST(LazyDocumentTest, Materialize) {
+  string_view json = "[1, {\"a\": [true, \"x\"]}, \"y\", 2.5]";
+  Document document{json};
+
+  Value object = document[1].Materialize();
+
+  ASSERT_EQ(object.type(), VType::kObject);
+  ASSERT_EQ(object["a"].size(), size_t{2});
+  EXPECT_EQ(object["a"][1].string(), "x");
+
+  EXPECT_EQ(document[2].Materialize().string(), "y");
+  EXPECT_DOUBLE_EQ(document[3].Materialize().number(), 2.5);
+  EXPECT_EQ(document.root().Materialize().size(), size_t{4});
+  EXPECT_EQ(document[4].Materialize().type(), VType::kNull);
+}
+
+TEST(LazyDocumentTest, Wide) {
+  std::u16string_view json = u"{\"kéy\": [\"välue\"]}";
+  json::BasicLazyDocument<char16_t> document{json};
+
+  EXPECT_EQ(document[u"kéy"][0].string(), u"välue");
+}
@@ -7,7 +7,10 @@
 //
 
 #include <iostream>
+#include <limits>
 #include <string>
+#include <thread>
+#include <vector>
 #include "gtest/gtest.h"
 #include "json/value/basic_value.h"
 
@@ -49,6 +52,107 @@ TEST(PrimitiveTest, Number) {
   EXPECT_FLOAT_EQ(value.number(), 22);
 }
 
+TEST(PrimitiveTest, Integer) {
+  // signed
+  {
+    Value value{int64_t{9007199254740993}};
+
+    EXPECT_EQ(value.type(), Value::Type::kNumber);
+    ASSERT_TRUE(value.IsInteger());
+    EXPECT_EQ(value.int64(), 9007199254740993);
+    EXPECT_FLOAT_EQ(value.number(), 9007199254740993.0);
+  }
+
+  // unsigned
+  {
+    Value value;
+    value.set_uint64(UINT64_MAX);
+
+    EXPECT_EQ(value.type(), Value::Type::kNumber);
+    ASSERT_TRUE(value.IsInteger());
+    EXPECT_EQ(value.uint64(), UINT64_MAX);
+  }
+
+  // double
+  {
+    Value value;
+    value.set_number(-2.5);
+
+    EXPECT_FALSE(value.IsInteger());
+    EXPECT_EQ(value.int64(), -2);
+  }
+}
+
+TEST(PrimitiveTest, IntegerClamp) {
+  // 18446744073709551616 does not fit in 64 bits and is kept as a double
+  {
+    Value value;
+    value.set_number(18446744073709551616.0);
+
+    EXPECT_EQ(value.uint64(), UINT64_MAX);
+    EXPECT_EQ(value.int64(), INT64_MAX);
+  }
+
+  {
+    Value value{json::BasicLazyNumber<char>{string_view{"-1e30"}}};
+
+    EXPECT_EQ(value.int64(), INT64_MIN);
+    EXPECT_EQ(value.uint64(), uint64_t{0});
+  }
+
+  {
+    Value value;
+    value.set_number(-1.5);
+
+    EXPECT_EQ(value.uint64(), uint64_t{0});
+  }
+
+  {
+    Value value;
+    value.set_number(std::numeric_limits<double>::quiet_NaN());
+
+    EXPECT_EQ(value.int64(), 0);
+    EXPECT_EQ(value.uint64(), uint64_t{0});
+  }
+
+  // integers of the other signedness
+  {
+    Value value;
+    value.set_uint64(UINT64_MAX);
+
+    EXPECT_EQ(value.int64(), INT64_MAX);
+  }
+
+  {
+    Value value{int64_t{-3}};
+
+    EXPECT_EQ(value.uint64(), uint64_t{0});
+  }
+}
+
+TEST(PrimitiveTest, LazyNumberThreads) {
+  const Value value{json::BasicLazyNumber<char>{string_view{"-12.5e1"}}};
+  std::vector<std::thread> threads;
+  std::vector<double> numbers(4);
+
+  // the first reads convert the letters at the same time
+  for (double &number : numbers) {
+    threads.emplace_back([&value, &number]() { number = value.number(); });
+  }
+
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+
+  for (double number : numbers) {
+    EXPECT_EQ(number, -125.0);
+  }
+
+  // copies keep the converted value
+  Value copy = value;
+  EXPECT_EQ(copy.int64(), -125);
+}
+
 TEST(PrimitiveTest, Bool) {
   Value value;
   value.set_boolean(true);